@@ -38,8 +38,13 @@ namespace ospray {
       DG_TEXCOORD    = (1<<9), /*!< calculate texture coords st */
       DG_TANGENTS    = (1<<10),/*!< calculate tangents, i.e. the partial
                                  derivatives of position wrt. texture coordinates */
+      DG_BAKED       = (1<<11),/*!< interpolate baked per-vertex AO and light
+                                 visibility, if the geometry has any */
     } DG_PostIntersectFlags;
 
+    //! maximum number of lights with baked visibility per geometry
+    constexpr int DG_MAX_BAKED_LIGHTS = 4;
+
     /*! differential geometry information that gives more detailed
         information on the actual geometry that a ray has hit */
     struct DifferentialGeometry {
@@ -53,12 +58,24 @@ namespace ospray {
       vec3f dPds; //!< tangent, the partial derivative of the hit-point wrt. texcoord s
       vec3f dPdt; //!< bi-tangent, the partial derivative of the hit-point wrt. texcoord t
       vec2f st; //!< texture coordinates if DG_TEXCOORD was set
+      float stScale {0.f}; /*!< texture space length per world space length
+                                around the hit-point if DG_TEXCOORD was set
+                                (0 if the geometry has no texcoords) */
+      float stWidth {0.f}; /*!< width of the ray's pixel footprint in texture
+                                space if DG_TEXCOORD was set, selects the mip
+                                level of texture lookups */
       vec4f color; /*! interpolated vertex color (rgba) if DG_COLOR was set;
                      defaults to vec4f(1.f) if queried but not present in geometry
                      */
       int32 materialID {-1}; /*!< hack for now - the materialID as stored in
                                  "prim.materialID" array (-1 if that value isn't
                                   specified) */
+      float bakedAO {-1.f}; /*!< interpolated baked ambient occlusion if DG_BAKED
+                                 was set, -1 if the geometry wasn't baked */
+      int32 numBakedLights {0};
+      float bakedLightVisibility[DG_MAX_BAKED_LIGHTS]; /*!< interpolated baked
+                                 visibility of the baked lights (see
+                                 renderer/simple_ao/VertexBaker.h) */
 
       ospray::Geometry *geometry{nullptr}; /*! pointer to hit-point's geometry */
       ospray::Material *material{nullptr}; /*! pointer to hit-point's material */
@@ -37,12 +37,14 @@ namespace ospray {
       simd::vec3f dPdt; //!< bi-tangent, the partial derivative of the hit-point
                         //   wrt. texcoord t
       simd::vec2f st; //!< texture coordinates if DG_TEXCOORD was set
+      simd::vfloat stWidth {0.f}; /*!< width of the ray's pixel footprint in
+                                       texture space if DG_TEXCOORD was set */
       simd::vec4f color; /*! interpolated vertex color (rgba) if DG_COLOR was set;
                      defaults to vec4f(1.f) if queried but not present in geometry
                      */
-      simd::vint materialID {-1}; /*!< hack for now - the materialID as stored in
-                                 "prim.materialID" array (-1 if that value isn't
-                                  specified) */
+      simd::vint materialID {-1}; /*!< dense MaterialTable ID if DG_MATERIALID
+                                       was set (0 is the renderer's fallback
+                                       material), -1 otherwise */
 
       /*! pointer to hit-point's geometry */
       simd::vptr<ospray::Geometry> geometry{nullptr};
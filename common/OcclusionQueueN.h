@@ -0,0 +1,121 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray_cpp
+#include "RayN.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief regroups live lanes of sparse RayN packets into dense packets
+     *         for occlusion queries
+
+        Secondary rays spawned from a partially active packet (and rays
+        which can be resolved without tracing) leave lanes idle in
+        rtcOccludedN(). Lanes are instead pushed one at a time, together with
+        a caller defined 'slot' identifying where the result belongs; once
+        simd::width rays are queued the packet is traced and the result of
+        each lane is handed back with its slot. The queue is meant to live
+        on the stack of the rendering thread, e.g. for a whole render job so
+        lanes of different primary packets are merged, and needs no
+        synchronization. */
+    struct OSPRAY_ALIGN(64) OcclusionQueueN
+    {
+      bool empty() const;
+      bool full()  const;
+
+      /*! \brief copy lane 'lane' of 'src' into the next free lane, returns
+       *         true if the queue is now full (i.e. flush() must be called
+       *         before the next push()) */
+      bool push(const RayN &src, int lane, int slot);
+
+      /*! \brief trace the queued rays with 'occludedFcn' (which has the
+       *         signature of SimdRenderer::isOccluded()) and call
+       *         'resultFcn(int slot, bool occluded)' for each queued ray */
+      template <typename OCCLUDED_FCN, typename RESULT_FCN>
+      void flush(OCCLUDED_FCN &&occludedFcn, RESULT_FCN &&resultFcn);
+
+      // Data //
+
+      RayN rays;
+      int  slots[simd::width];
+      int  count {0};
+
+      // NOTE(jda) - lanes traced / (packets traced * simd::width) gives the
+      //             achieved SIMD utilization of the occlusion queries
+      size_t packetsTraced {0};
+      size_t lanesTraced {0};
+    };
+
+    // Inlined member definitions /////////////////////////////////////////////
+
+    inline bool OcclusionQueueN::empty() const
+    {
+      return count == 0;
+    }
+
+    inline bool OcclusionQueueN::full() const
+    {
+      return count == simd::width;
+    }
+
+    inline bool OcclusionQueueN::push(const RayN &src, int lane, int slot)
+    {
+      const int i = count++;
+
+      rays.org.x[i] = src.org.x[lane];
+      rays.org.y[i] = src.org.y[lane];
+      rays.org.z[i] = src.org.z[lane];
+      rays.dir.x[i] = src.dir.x[lane];
+      rays.dir.y[i] = src.dir.y[lane];
+      rays.dir.z[i] = src.dir.z[lane];
+      rays.t0[i]    = src.t0[lane];
+      rays.t[i]     = src.t[lane];
+      rays.time[i]  = src.time[lane];
+      rays.mask[i]  = src.mask[lane];
+
+      slots[i] = slot;
+
+      return full();
+    }
+
+    template <typename OCCLUDED_FCN, typename RESULT_FCN>
+    inline void OcclusionQueueN::flush(OCCLUDED_FCN &&occludedFcn,
+                                       RESULT_FCN &&resultFcn)
+    {
+      if (empty())
+        return;
+
+      const auto active = simd::vint(simd::step) < simd::vint{count};
+
+      rays.geomID = RTC_INVALID_GEOMETRY_ID;
+      rays.primID = RTC_INVALID_GEOMETRY_ID;
+      rays.instID = RTC_INVALID_GEOMETRY_ID;
+
+      const auto occluded = occludedFcn(active, rays);
+
+      for (int i = 0; i < count; ++i)
+        resultFcn(slots[i], bool(occluded[i]));
+
+      packetsTraced++;
+      lanesTraced += count;
+      count = 0;
+    }
+
+  }// ::ospray::cpp_renderer
+} // ::ospray
@@ -107,5 +107,25 @@ namespace ospray {
       resetRay(rays[i]);
     }
 
+    inline std::pair<simd::vfloat, simd::vfloat> intersectBox(const RayN &ray,
+                                                              const box3f &box)
+    {
+      const simd::vec3f rcpDir {1.f / ray.dir.x, 1.f / ray.dir.y,
+                                1.f / ray.dir.z};
+
+      const simd::vec3f mins = (simd::vec3f{box.lower} - ray.org) * rcpDir;
+      const simd::vec3f maxs = (simd::vec3f{box.upper} - ray.org) * rcpDir;
+
+      const auto nearX = simd::min(mins.x, maxs.x);
+      const auto nearY = simd::min(mins.y, maxs.y);
+      const auto nearZ = simd::min(mins.z, maxs.z);
+      const auto farX  = simd::max(mins.x, maxs.x);
+      const auto farY  = simd::max(mins.y, maxs.y);
+      const auto farZ  = simd::max(mins.z, maxs.z);
+
+      return {simd::max(simd::max(nearX, nearY), simd::max(nearZ, ray.t0)),
+              simd::min(simd::min(farX, farY), simd::min(farZ, ray.t))};
+    }
+
   }// ::ospray::cpp_renderer
 } // ::ospray
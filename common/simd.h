@@ -17,6 +17,7 @@
 #pragma once
 
 #include "../embc/simd/simd.h"
+#include "../math/fast_math.h"
 
 namespace ospcommon {
 
@@ -269,18 +270,45 @@ namespace ospray {
       SIMD_T::scatter(mask, to, ofs, from);
     }
 
+    // Transcendentals (see math/fast_math.h for error bounds) //
+
+    inline void sincos(const vfloat &in, vfloat &s, vfloat &c)
+    {
+      ospcommon::math_detail::sincos(in, s, c);
+    }
+
     inline vfloat sin(const vfloat &in)
     {
-      vfloat result = in;
-      foreach_v(result, [](float &v, int i) { v = std::sin(v); });
-      return result;
+      vfloat s, c;
+      ospcommon::math_detail::sincos(in, s, c);
+      return s;
     }
 
     inline vfloat cos(const vfloat &in)
     {
-      vfloat result = in;
-      foreach_v(result, [](float &v, int i) { v = std::cos(v); });
-      return result;
+      vfloat s, c;
+      ospcommon::math_detail::sincos(in, s, c);
+      return c;
+    }
+
+    inline vfloat exp(const vfloat &in)
+    {
+      return ospcommon::math_detail::exp(in);
+    }
+
+    inline vfloat log(const vfloat &in)
+    {
+      return ospcommon::math_detail::log(in);
+    }
+
+    inline vfloat pow(const vfloat &x, const vfloat &y)
+    {
+      return ospcommon::math_detail::pow(x, y);
+    }
+
+    inline vfloat pow(const vfloat &x, float y)
+    {
+      return ospcommon::math_detail::pow(x, vfloat(y));
     }
 
   }// namespace simd
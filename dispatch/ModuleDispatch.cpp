@@ -0,0 +1,67 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+// ospray
+#include "ospray/common/OSPCommon.h"
+// ospray_cpp
+#include "cpu_isa.h"
+// std
+#include <cstdlib>
+#include <stdexcept>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // NOTE(jda) - In multi-ISA builds the 'cpp' module is only this file: it
+    //             loads the matching 'cpp_<isa>' module, which registers all
+    //             renderers, geometries, volumes, etc. under the usual names.
+    //             Setting OSPRAY_CPP_ISA=sse4|avx2|avx512 in the environment
+    //             selects an older ISA than the host supports (for debugging
+    //             and performance comparisons).
+
+    extern "C" void ospray_init_module_cpp()
+    {
+      const CpuIsa hostIsa = detectCpuIsa();
+
+      if (hostIsa == CpuIsa::UNSUPPORTED) {
+        throw std::runtime_error("The 'cpp' module requires at least SSE4.2!");
+      }
+
+      CpuIsa isa = hostIsa;
+
+      const char *isaOverride = getenv("OSPRAY_CPP_ISA");
+      if (isaOverride != nullptr) {
+        const CpuIsa requested = isaFromString(isaOverride);
+        if (requested == CpuIsa::UNSUPPORTED) {
+          throw std::runtime_error(std::string("Unknown OSPRAY_CPP_ISA '")
+                                   + isaOverride + "' (use sse4, avx2 or "
+                                   "avx512)");
+        }
+
+        if (requested > hostIsa) {
+          throw std::runtime_error(std::string("OSPRAY_CPP_ISA '")
+                                   + isaOverride + "' is not supported by "
+                                   "this CPU");
+        }
+
+        isa = requested;
+      }
+
+      loadLocalModule("cpp_" + isaModuleSuffix(isa));
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
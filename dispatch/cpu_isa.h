@@ -0,0 +1,138 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// NOTE(jda) - This header must not include anything which depends on the
+//             target ISA (embc, common/simd.h, ...): it is compiled for the
+//             baseline ISA as part of the dispatching 'cpp' module.
+
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#  include <intrin.h>
+#else
+#  include <cpuid.h>
+#endif
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // ISAs the module is compiled for, ordered from oldest to newest //
+
+    enum class CpuIsa
+    {
+      UNSUPPORTED = 0,
+      SSE4,
+      AVX2,
+      AVX512
+    };
+
+    inline std::string isaModuleSuffix(CpuIsa isa)
+    {
+      switch (isa) {
+      case CpuIsa::SSE4:   return "sse4";
+      case CpuIsa::AVX2:   return "avx2";
+      case CpuIsa::AVX512: return "avx512";
+      default:             return "";
+      }
+    }
+
+    inline CpuIsa isaFromString(const std::string &name)
+    {
+      if (name == "sse4")   return CpuIsa::SSE4;
+      if (name == "avx2")   return CpuIsa::AVX2;
+      if (name == "avx512") return CpuIsa::AVX512;
+      return CpuIsa::UNSUPPORTED;
+    }
+
+    // CPUID helpers //
+
+    inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+    {
+#ifdef _WIN32
+      int r[4];
+      __cpuidex(r, int(leaf), int(subleaf));
+      for (int i = 0; i < 4; ++i)
+        regs[i] = uint32_t(r[i]);
+#else
+      __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    inline uint64_t xgetbv0()
+    {
+#ifdef _WIN32
+      return _xgetbv(0);
+#else
+      uint32_t eax, edx;
+      __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+      return (uint64_t(edx) << 32) | eax;
+#endif
+    }
+
+    // Returns the newest ISA supported by both the CPU and the OS (i.e. the
+    // OS saves the wider register state on context switches).
+    inline CpuIsa detectCpuIsa()
+    {
+      auto bit = [](uint32_t reg, int b) { return (reg >> b) & 1; };
+
+      uint32_t r0[4], r1[4], r7[4] = {0, 0, 0, 0}, rx[4] = {0, 0, 0, 0};
+
+      cpuid(0, 0, r0);
+      const uint32_t maxLeaf = r0[0];
+      cpuid(1, 0, r1);
+      if (maxLeaf >= 7)
+        cpuid(7, 0, r7);
+      cpuid(0x80000000, 0, r0);
+      if (r0[0] >= 0x80000001)
+        cpuid(0x80000001, 0, rx);
+
+      const bool sse42 = bit(r1[2], 20);
+      if (!sse42)
+        return CpuIsa::UNSUPPORTED;
+
+      const bool osxsave = bit(r1[2], 27);
+      const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+
+      const bool ymmState = (xcr0 & 0x06) == 0x06;
+      const bool zmmState = (xcr0 & 0xe6) == 0xe6;
+
+      const bool avx2 = ymmState &&
+                        bit(r1[2], 28) && // AVX
+                        bit(r1[2], 12) && // FMA
+                        bit(r1[2], 29) && // F16C
+                        bit(r7[1],  5) && // AVX2
+                        bit(r7[1],  3) && // BMI1
+                        bit(r7[1],  8) && // BMI2
+                        bit(rx[2],  5);   // LZCNT
+
+      if (!avx2)
+        return CpuIsa::SSE4;
+
+      const bool avx512 = zmmState &&
+                          bit(r7[1], 16) && // AVX512F
+                          bit(r7[1], 17) && // AVX512DQ
+                          bit(r7[1], 28) && // AVX512CD
+                          bit(r7[1], 30) && // AVX512BW
+                          bit(r7[1], 31);   // AVX512VL
+
+      return avx512 ? CpuIsa::AVX512 : CpuIsa::AVX2;
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -28,7 +28,44 @@ namespace ospray {
       virtual void postIntersect(DifferentialGeometry &dg,
                                  const Ray &ray,
                                  int flags) const = 0;
+
+      // Material access (see renderer/MaterialTable.h) //
+
+      /*! number of materials this geometry can reference */
+      virtual int numMaterials() const;
+
+      /*! material referenced by local index 'i' (may be nullptr) */
+      virtual ospray::Material *getMaterial(int i) const;
+
+      /*! per-primitive local material indices, nullptr if uniform */
+      virtual const uint32 *primMaterialIndices() const;
+
+      /*! local material index used if primMaterialIndices() is nullptr */
+      virtual int geomMaterialIndex() const;
     };
 
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline int Geometry::numMaterials() const
+    {
+      return 1;
+    }
+
+    inline ospray::Material *Geometry::getMaterial(int i) const
+    {
+      UNUSED(i);
+      return material.ptr;
+    }
+
+    inline const uint32 *Geometry::primMaterialIndices() const
+    {
+      return nullptr;
+    }
+
+    inline int Geometry::geomMaterialIndex() const
+    {
+      return 0;
+    }
+
   }// namespace cpp_renderer
 }// namespace ospray
@@ -16,12 +16,15 @@
 
 // ospray
 #include "TriangleMesh.h"
+#include "../renderer/TransparentShadows.h"
 #include "common/Model.h"
 #include "common/Data.h"
 // embree
 #include "embree2/rtcore.h"
 #include "embree2/rtcore_scene.h"
 #include "embree2/rtcore_geometry.h"
+// std
+#include <atomic>
 
 using std::cout;
 using std::endl;
@@ -29,11 +32,20 @@ using std::endl;
 namespace ospray {
   namespace cpp_renderer {
 
+    //! source of TriangleMesh::version values
+    static std::atomic<uint64_t> nextVersion {1};
+
     std::string TriangleMesh::toString() const
     {
       return "ospray::cpp_renderer::TriangleMesh";
     }
 
+    void TriangleMesh::commit()
+    {
+      Geometry::commit();
+      version = nextVersion++;
+    }
+
     void TriangleMesh::finalize(Model *model)
     {
       static int numPrints = 0;
@@ -45,6 +57,8 @@ namespace ospray {
 
       RTCScene embreeSceneHandle = model->embreeSceneHandle;
 
+      version = nextVersion++;
+
       vertexData = getParamData("vertex",getParamData("position"));
       normalData = getParamData("vertex.normal",getParamData("normal"));
       colorData  = getParamData("vertex.color",getParamData("color"));
@@ -77,7 +91,7 @@ namespace ospray {
       }
 #endif
 
-      size_t numVerts = -1;
+      numVerts = -1;
       switch (indexData->type) {
       case OSP_INT:
       case OSP_UINT:  numTris = indexData->size() / 3; idxSize = 3; break;
@@ -117,6 +131,12 @@ namespace ospray {
                    (void*)this->index,0,
                    sizeOf(indexData->type));
 
+#if USE_EMBREE_STREAMS
+      // NOTE(jda) - a no-op unless a renderer asks for transparent shadows
+      rtcSetOcclusionFilterFunctionN(embreeSceneHandle, eMesh,
+                                     transparentShadowFilter);
+#endif
+
       bounds = empty;
 
       for (size_t i = 0; i < numVerts*vtxSize; i += vtxSize)
@@ -156,10 +176,39 @@ namespace ospray {
         dg.st = (1.f-ray.u-ray.v) * (texcoord[idx.x])
                 + ray.u * (texcoord[idx.y])
                 + ray.v * (texcoord[idx.z]);
+
+        // NOTE(jda) - isotropic texel density of the triangle: the square
+        //             root of its texture space over its world space area
+        auto &v0 = reinterpret_cast<const vec3f&>(vertex[idx.x*vtxSize]);
+        auto &v1 = reinterpret_cast<const vec3f&>(vertex[idx.y*vtxSize]);
+        auto &v2 = reinterpret_cast<const vec3f&>(vertex[idx.z*vtxSize]);
+        const vec2f dst01 = texcoord[idx.y] - texcoord[idx.x];
+        const vec2f dst02 = texcoord[idx.z] - texcoord[idx.x];
+        const float stArea = std::abs(dst01.x * dst02.y - dst01.y * dst02.x);
+        const float area   = length(cross(v1 - v0, v2 - v0));
+        dg.stScale = area > 0.f ? std::sqrt(stArea / area) : 0.f;
       } else {
         dg.st = vec2f{0.0f};
       }
 
+      if ((flags & DG_BAKED) && !bakedAO.empty()) {
+        const float w0 = 1.f-ray.u-ray.v;
+
+        dg.bakedAO = w0 * bakedAO[idx.x]
+                     + ray.u * bakedAO[idx.y]
+                     + ray.v * bakedAO[idx.z];
+
+        const auto *vis = bakedLightVisibility.data();
+        const int   n   = numBakedLights;
+
+        dg.numBakedLights = n;
+        for (int l = 0; l < n; ++l) {
+          dg.bakedLightVisibility[l] = w0 * vis[idx.x*n + l]
+                                       + ray.u * vis[idx.y*n + l]
+                                       + ray.v * vis[idx.z*n + l];
+        }
+      }
+
       if (flags & DG_TANGENTS) {
         bool fallback = true;
         if (texcoord) {
@@ -201,6 +250,27 @@ namespace ospray {
       }
     }
 
+    int TriangleMesh::numMaterials() const
+    {
+      return materialList ? materialListData->numItems : 1;
+    }
+
+    ospray::Material *TriangleMesh::getMaterial(int i) const
+    {
+      return materialList ? materialList[i] : material.ptr;
+    }
+
+    const uint32 *TriangleMesh::primMaterialIndices() const
+    {
+      // NOTE(jda) - without a material list all primitives use 'material'
+      return materialList ? prim_materialID : nullptr;
+    }
+
+    int TriangleMesh::geomMaterialIndex() const
+    {
+      return materialList ? std::max(geom_materialID, 0) : 0;
+    }
+
     OSP_REGISTER_GEOMETRY(TriangleMesh, cpp_triangles);
     OSP_REGISTER_GEOMETRY(TriangleMesh, cpp_trianglemesh);
 
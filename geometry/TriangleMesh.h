@@ -17,6 +17,9 @@
 #pragma once
 
 #include "../geometry/Geometry.h"
+// std
+#include <cstdint>
+#include <vector>
 
 namespace ospray {
   namespace cpp_renderer {
@@ -26,6 +29,7 @@ namespace ospray {
       // ospray::Geometry interface ///////////////////////////////////////////
 
       std::string toString() const override;
+      void commit() override;
       void finalize(Model *model) override;
 
       // ospray::cpp_renderer::Geometry interface /////////////////////////////
@@ -34,9 +38,15 @@ namespace ospray {
                          const Ray &ray,
                          int flags) const override;
 
+      int numMaterials() const override;
+      ospray::Material *getMaterial(int i) const override;
+      const uint32 *primMaterialIndices() const override;
+      int geomMaterialIndex() const override;
+
       // Data members /////////////////////////////////////////////////////////
 
       size_t numTris{-1};
+      size_t numVerts{0};
       size_t idxSize{0};
       size_t vtxSize{0};
       size_t norSize{0};
@@ -59,7 +69,18 @@ namespace ospray {
       Ref<Data> materialListData; /*!< data array for per-prim materials */
       uint32    eMesh;   /*!< embree triangle mesh handle */
 
+      /*! unique across meshes, renewed by every commit() and finalize(), so
+          caches of derived data notice data arrays updated in place */
+      uint64_t version {0};
+
       void** ispcMaterialPtrs; /*!< pointers to ISPC equivalent materials */
+
+      // Baked lighting (see renderer/simple_ao/VertexBaker.h) //
+
+      std::vector<float> bakedAO; //!< per-vertex ambient occlusion
+      std::vector<float> bakedLightVisibility; //!< per vertex, per light
+      int      numBakedLights {0};
+      uint64_t bakeKey {0}; //!< identifies the bake's inputs, 0 if not baked
     };
 
   }// namespace cpp_renderer
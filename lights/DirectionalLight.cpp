@@ -77,6 +77,18 @@ namespace ospray {
       return res;
     }
 
+    Light_Bounds DirectionalLight::bounds() const
+    {
+      Light_Bounds res;
+
+      res.bounded     = true;
+      res.axis        = frame.vz;
+      res.cosAngle    = cosAngle;
+      res.maxRadiance = reduce_max(radiance);
+
+      return res;
+    }
+
     OSP_REGISTER_LIGHT(DirectionalLight, cpp_DirectionalLight);
     OSP_REGISTER_LIGHT(DirectionalLight, cpp_DistantLight);
     OSP_REGISTER_LIGHT(DirectionalLight, cpp_distant);
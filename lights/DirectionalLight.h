@@ -37,6 +37,8 @@ namespace ospray {
                            const vec3f &dir,
                            float maxDist) const override;
 
+        Light_Bounds bounds() const override;
+
       private:
 
         vec3f direction {0.f, 0.f, 1.f};//!< Direction of the emitted rays
@@ -24,5 +24,10 @@ namespace ospray {
       return "ospray::cpp_renderer::Light";
     }
 
+    Light_Bounds cpp_renderer::Light::bounds() const
+    {
+      return Light_Bounds{};
+    }
+
   }
 }
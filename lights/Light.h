@@ -38,9 +38,25 @@ namespace ospray {
                      //   been sampled
     };
 
+    /*! \brief conservative bounds of what a light can contribute anywhere
+     *         in the scene, used to cull lights (see LightTree)
+
+        Only lights whose directions towards them don't depend on the
+        shading point (i.e. distant lights) can be bounded by a cone. */
+    struct Light_Bounds
+    {
+      bool  bounded {false};      //!< false: the light is never culled
+      vec3f axis {0.f, 0.f, 1.f}; //!< axis of the cone of directions
+                                  //   towards the light
+      float cosAngle {-1.f};      //!< cosine of the cone's half angle
+      float maxRadiance {inf};    //!< upper bound of reduce_max() of any
+                                  //   Light_SampleRes::weight
+    };
+
     struct OSPRAY_SDK_INTERFACE Light : public ::ospray::Light
     {
       virtual std::string toString() const override;
+      virtual Light_Bounds bounds() const;
       virtual Light_SampleRes sample(const DifferentialGeometry &dg,
                                      const vec2f &s) const = 0;
       virtual Light_EvalRes eval(const DifferentialGeometry &dg,
@@ -0,0 +1,128 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+/*! \brief O(1) sampling of discrete distributions (Walker/Vose alias method) */
+
+// std
+#include <algorithm>
+#include <vector>
+
+namespace ospcommon {
+
+  struct AliasTable
+  {
+    /*! \brief build the table for sampling index i with probability
+     *         weights[i] / sum(weights), negative weights count as 0 */
+    void build(const std::vector<float> &weights);
+
+    void clear();
+    bool empty() const;
+    int  size() const;
+
+    //! \brief index for a uniform random number 'u' in [0, 1)
+    int sample(float u) const;
+
+    //! \brief probability of sample() returning 'i'
+    float pdf(int i) const;
+
+  private:
+
+    struct Bin
+    {
+      float threshold; //!< keep the bin's own index below this
+      int   alias;     //!< index returned otherwise
+    };
+
+    std::vector<Bin>   bins;
+    std::vector<float> probabilities;
+  };
+
+  // Inlined member functions /////////////////////////////////////////////////
+
+  inline void AliasTable::build(const std::vector<float> &weights)
+  {
+    clear();
+
+    const int n = weights.size();
+
+    double sum = 0.0;
+    for (const auto w : weights)
+      sum += std::max(w, 0.f);
+
+    if (n == 0 || sum <= 0.0)
+      return;
+
+    bins.resize(n);
+    probabilities.resize(n);
+
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+
+    for (int i = 0; i < n; ++i) {
+      const double p = std::max(weights[i], 0.f) / sum;
+      probabilities[i] = p;
+      scaled[i] = p * n;
+      (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+      const int s = small.back(); small.pop_back();
+      const int l = large.back(); large.pop_back();
+
+      bins[s] = {float(scaled[s]), l};
+
+      scaled[l] -= 1.0 - scaled[s];
+      (scaled[l] < 1.0 ? small : large).push_back(l);
+    }
+
+    // NOTE(jda) - leftovers are (up to rounding) exactly 1
+    for (const auto i : large) bins[i] = {1.f, i};
+    for (const auto i : small) bins[i] = {1.f, i};
+  }
+
+  inline void AliasTable::clear()
+  {
+    bins.clear();
+    probabilities.clear();
+  }
+
+  inline bool AliasTable::empty() const
+  {
+    return bins.empty();
+  }
+
+  inline int AliasTable::size() const
+  {
+    return static_cast<int>(bins.size());
+  }
+
+  inline int AliasTable::sample(float u) const
+  {
+    const int   n = size();
+    const float x = u * n;
+    const int   i = std::min(static_cast<int>(x), n - 1);
+    const auto &bin = bins[i];
+    return (x - i) < bin.threshold ? i : bin.alias;
+  }
+
+  inline float AliasTable::pdf(int i) const
+  {
+    return probabilities[i];
+  }
+
+}// namespace ospcommon
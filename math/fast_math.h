@@ -0,0 +1,258 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+/*! \brief single precision transcendental functions for float and vfloat */
+
+// The kernels below are written once against a small set of primitives
+// (floori, select, bit casts) which are overloaded for both float and the
+// native embc vfloat, so the scalar and SIMD renderers produce the same bits
+// for the same inputs. Polynomials are the Cephes single precision ones.
+//
+// Measured maximum errors (against double precision libm, SSE4/AVX2/AVX-512
+// builds give identical results):
+//
+//   sin/cos/sincos : abs. error <= 6e-8 for |x| <= 8192; beyond that the
+//                    range reduction loses precision and error grows with |x|
+//   exp            : rel. error <= 9e-8 for x in [-87, 88]; results are
+//                    flushed to 0 below -87.3 and saturate at exp(88) ~ 1.65e38
+//                    above 88 (no denormals, no inf)
+//   log            : abs. error <= 4e-8 for x in [0.5, 2], rel. error
+//                    <= 8e-8 elsewhere; log(0) = -inf, log(x < 0) = NaN,
+//                    denormal inputs are not supported
+//   pow            : computed as exp(y * log(x)), so rel. error grows with
+//                    |y * log(x)|; <= 7e-6 for x in [1e-3, 1], y <= 128 (the
+//                    specular range); pow(x, 0) = 1, pow(x <= 0, y != 0) = 0
+//                    (no integer exponent handling)
+
+#include "../embc/simd/simd.h"
+// std
+#include <cmath>
+#include <cstring>
+
+namespace ospcommon {
+  namespace math_detail {
+
+    // Primitives (float) //
+
+    inline int floori(float x)
+    {
+      return static_cast<int>(std::floor(x));
+    }
+
+    inline float toFloat(int i)
+    {
+      return static_cast<float>(i);
+    }
+
+    inline float select(bool m, float t, float f)
+    {
+      return m ? t : f;
+    }
+
+    inline int bitsAsInt(float x)
+    {
+      int i;
+      std::memcpy(&i, &x, sizeof(float));
+      return i;
+    }
+
+    inline float bitsAsFloat(int i)
+    {
+      float x;
+      std::memcpy(&x, &i, sizeof(float));
+      return x;
+    }
+
+    // Primitives (vfloat) //
+
+    using vfloat = embree::vfloatx;
+    using vint   = embree::vintx;
+
+    // NOTE(jda) - floori() and select() for vfloat are found in embree:: by
+    //             argument dependent lookup
+
+    inline vfloat toFloat(const vint &i)
+    {
+      return vfloat(i);
+    }
+
+    // NOTE(jda) - embc only provides asInt() for some widths, so do the bit
+    //             casts here with the same ISA selection as varying.h
+    inline vint bitsAsInt(const vfloat &x)
+    {
+#if defined(__AVX512F__)
+      return _mm512_castps_si512(x);
+#elif defined(__AVX__)
+      return _mm256_castps_si256(x);
+#else
+      return _mm_castps_si128(x);
+#endif
+    }
+
+    inline vfloat bitsAsFloat(const vint &i)
+    {
+#if defined(__AVX512F__)
+      return _mm512_castsi512_ps(i);
+#elif defined(__AVX__)
+      return _mm256_castsi256_ps(i);
+#else
+      return _mm_castsi128_ps(i);
+#endif
+    }
+
+    // Kernels ////////////////////////////////////////////////////////////////
+
+    template <typename FLOAT_T>
+    inline void sincos(const FLOAT_T &x, FLOAT_T &s, FLOAT_T &c)
+    {
+      const FLOAT_T ax = embree::abs(x);
+
+      // reduce to [-pi/4, pi/4] around the nearest even multiple of pi/4
+      auto j = floori(ax * 1.27323954473516f);
+      j = (j + 1) & ~1;
+      const FLOAT_T y = toFloat(j);
+
+      const FLOAT_T xr = ((ax - y * 0.78515625f)
+                             - y * 2.4187564849853515625e-4f)
+                             - y * 3.77489497744594108e-8f;
+      const FLOAT_T z  = xr * xr;
+
+      const FLOAT_T ps = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z
+                          - 1.6666654611e-1f) * z * xr + xr;
+      const FLOAT_T pc = ((2.443315711809948e-5f * z - 1.388731625493765e-3f)
+                          * z + 4.166664568298827e-2f) * z * z
+                          - 0.5f * z + 1.f;
+
+      const auto swap = (j & 2) != 0;
+      s = select(swap, pc, ps);
+      c = select(swap, ps, pc);
+
+      s = select((j & 4) != 0, -s, s);
+      s = select(x < 0.f, -s, s);
+      c = select(((j + 2) & 4) != 0, -c, c);
+    }
+
+    template <typename FLOAT_T>
+    inline FLOAT_T exp(const FLOAT_T &in)
+    {
+      // NOTE(jda) - above ~88.03 the 2^n scale below overflows to inf
+      FLOAT_T x = embree::min(embree::max(in, FLOAT_T(-88.3762626647949f)),
+                              FLOAT_T(88.f));
+
+      // x = n * ln(2) + r, |r| <= ln(2)/2
+      const auto    n  = floori(x * 1.44269504088896341f + 0.5f);
+      const FLOAT_T fn = toFloat(n);
+      x = x - fn * 0.693359375f - fn * -2.12194440e-4f;
+
+      const FLOAT_T z = x * x;
+      FLOAT_T y = 1.9875691500e-4f;
+      y = y * x + 1.3981999507e-3f;
+      y = y * x + 8.3334519073e-3f;
+      y = y * x + 4.1665795894e-2f;
+      y = y * x + 1.6666665459e-1f;
+      y = y * x + 5.0000001201e-1f;
+      y = y * z + x + 1.f;
+
+      // scale by 2^n
+      return y * bitsAsFloat((n + 127) << 23);
+    }
+
+    template <typename FLOAT_T>
+    inline FLOAT_T log(const FLOAT_T &in)
+    {
+      // split into mantissa in [0.5, 1) and exponent
+      const auto bits = bitsAsInt(in);
+      FLOAT_T e = toFloat(((bits >> 23) & 0xff) - 126);
+      FLOAT_T m = bitsAsFloat((bits & 0x807fffff) | 0x3f000000);
+
+      const auto small = m < 0.707106781186547524f;
+      e = select(small, e - 1.f, e);
+      m = select(small, m + m, m) - 1.f;
+
+      const FLOAT_T z = m * m;
+      FLOAT_T y = 7.0376836292e-2f;
+      y = y * m - 1.1514610310e-1f;
+      y = y * m + 1.1676998740e-1f;
+      y = y * m - 1.2420140846e-1f;
+      y = y * m + 1.4249322787e-1f;
+      y = y * m - 1.6668057665e-1f;
+      y = y * m + 2.0000714765e-1f;
+      y = y * m - 2.4999993993e-1f;
+      y = y * m + 3.3333331174e-1f;
+      y = y * m * z;
+
+      y = y + e * -2.12194440e-4f;
+      y = y - 0.5f * z;
+      FLOAT_T result = m + y + e * 0.693359375f;
+
+      // special values
+      result = select(in == 0.f, FLOAT_T(-INFINITY), result);
+      result = select(in < 0.f,  FLOAT_T(NAN),       result);
+      result = select(in == FLOAT_T(INFINITY), in,   result);
+      result = select(in != in, in, result);
+      return result;
+    }
+
+    template <typename FLOAT_T>
+    inline FLOAT_T pow(const FLOAT_T &x, const FLOAT_T &y)
+    {
+      FLOAT_T result = exp(y * log(embree::max(x, FLOAT_T(1e-37f))));
+      result = select(x <= 0.f, FLOAT_T(0.f), result);
+      result = select(y == 0.f, FLOAT_T(1.f), result);
+      return result;
+    }
+
+  }// namespace math_detail
+
+  // Scalar fast math ///////////////////////////////////////////////////////
+
+  inline void fast_sincos(float x, float &s, float &c)
+  {
+    math_detail::sincos(x, s, c);
+  }
+
+  inline float fast_sin(float x)
+  {
+    float s, c;
+    math_detail::sincos(x, s, c);
+    return s;
+  }
+
+  inline float fast_cos(float x)
+  {
+    float s, c;
+    math_detail::sincos(x, s, c);
+    return c;
+  }
+
+  inline float fast_exp(float x)
+  {
+    return math_detail::exp(x);
+  }
+
+  inline float fast_log(float x)
+  {
+    return math_detail::log(x);
+  }
+
+  inline float fast_pow(float x, float y)
+  {
+    return math_detail::pow(x, y);
+  }
+
+}// namespace ospcommon
@@ -26,13 +26,14 @@
 // http://people.cs.kuleuven.be/~philip.dutre/GI/
 
 #include "ospcommon/vec.h"
+#include "fast_math.h"
 
 namespace ospcommon {
 
   inline vec3f cartesian(float phi, float sinTheta, float cosTheta)
   {
-    double sinPhi = sin(phi);
-    double cosPhi = cos(phi);
+    float sinPhi, cosPhi;
+    fast_sincos(phi, sinPhi, cosPhi);
     return vec3f(cosPhi * sinTheta, sinPhi * sinTheta, cosTheta);
   }
 
@@ -102,8 +103,8 @@ namespace ospcommon {
   {
     const float r = sqrtf(s.x) * radius;
     const float phi = static_cast<float>(two_pi) * s.y;
-    double sinPhi = sin(phi);
-    double cosPhi = cos(phi);
+    float sinPhi, cosPhi;
+    fast_sincos(phi, sinPhi, cosPhi);
     return vec3f(r * cosPhi, r * sinPhi, 0.f);
   }
 
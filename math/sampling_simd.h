@@ -0,0 +1,121 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+/*! \brief SIMD (vfloat) variants of the functions in sampling.h */
+
+// Same conventions as sampling.h: the vec2f 's'ample is the last parameter,
+// and every function produces the same result per lane as its scalar
+// counterpart, as both use the kernels from fast_math.h.
+
+#include "sampling.h"
+#include "../common/simd.h"
+
+namespace ospray {
+  namespace simd {
+
+    inline vec3f cartesian(const vfloat &phi,
+                           const vfloat &sinTheta,
+                           const vfloat &cosTheta)
+    {
+      vfloat sinPhi, cosPhi;
+      simd::sincos(phi, sinPhi, cosPhi);
+      return vec3f(cosPhi * sinTheta, sinPhi * sinTheta, cosTheta);
+    }
+
+    inline vec3f cartesian(const vfloat &phi, const vfloat &cosTheta)
+    {
+      const auto sinTheta = simd::sqrt(simd::max(1.f - cosTheta*cosTheta, 0.f));
+      return cartesian(phi, sinTheta, cosTheta);
+    }
+
+    // cosine-weighted sampling of hemisphere oriented along the +z-axis //////
+
+    inline vec3f cosineSampleHemisphere(const vec2f &s)
+    {
+      const vfloat phi = static_cast<float>(ospcommon::two_pi) * s.x;
+      const vfloat cosTheta = simd::sqrt(s.y);
+      const vfloat sinTheta = simd::sqrt(1.0f - s.y);
+      return cartesian(phi, sinTheta, cosTheta);
+    }
+
+    inline vfloat cosineSampleHemispherePDF(const vec3f &dir)
+    {
+      return dir.z * float(1.0 / M_PI);
+    }
+
+    inline vfloat cosineSampleHemispherePDF(const vfloat &cosTheta)
+    {
+      return cosTheta * float(1.0 / M_PI);
+    }
+
+    // power cosine-weighted sampling of hemisphere oriented along +z-axis ////
+
+    inline vec3f powerCosineSampleHemisphere(const float n, const vec2f &s)
+    {
+      const vfloat phi = static_cast<float>(ospcommon::two_pi) * s.x;
+      const vfloat cosTheta = simd::pow(s.y, 1.0f / (n + 1.0f));
+      return cartesian(phi, cosTheta);
+    }
+
+    inline vfloat powerCosineSampleHemispherePDF(const vfloat &cosTheta,
+                                                 const float n)
+    {
+      return ((n + 1.0f) * float(0.5 / M_PI)) * simd::pow(cosTheta, n);
+    }
+
+    inline vfloat powerCosineSampleHemispherePDF(const vec3f &dir,
+                                                 const float n)
+    {
+      return powerCosineSampleHemispherePDF(dir.z, n);
+    }
+
+    // uniform sampling of cone of directions oriented along the +z-axis //////
+
+    inline vec3f uniformSampleCone(const float cosAngle, const vec2f &s)
+    {
+      const vfloat phi = static_cast<float>(ospcommon::two_pi) * s.x;
+      const vfloat cosTheta = 1.0f - s.y * (1.0f - cosAngle);
+      return cartesian(phi, cosTheta);
+    }
+
+    // NOTE(jda) - the cone PDF is constant, use ospcommon::uniformSampleConePDF
+
+    // uniform sampling of disk ///////////////////////////////////////////////
+
+    inline vec3f uniformSampleDisk(const float radius, const vec2f &s)
+    {
+      const vfloat r = simd::sqrt(s.x) * radius;
+      const vfloat phi = static_cast<float>(ospcommon::two_pi) * s.y;
+      vfloat sinPhi, cosPhi;
+      simd::sincos(phi, sinPhi, cosPhi);
+      return vec3f(r * cosPhi, r * sinPhi, vfloat(0.f));
+    }
+
+    // uniform sampling of triangle abc ///////////////////////////////////////
+
+    inline vec3f uniformSampleTriangle(const vec3f &a,
+                                       const vec3f &b,
+                                       const vec3f &c,
+                                       const vec2f &s)
+    {
+      const vfloat su = simd::sqrt(s.x);
+      return c + (1.0f - su) * (a-c) + (s.y*su) * (b-c);
+    }
+
+  }// namespace simd
+}// namespace ospray
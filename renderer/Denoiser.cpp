@@ -0,0 +1,276 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "Denoiser.h"
+// ospray
+#include "fb/LocalFB.h"
+#include "ospcommon/tasking/parallel_for.h"
+// std
+#include <algorithm>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // Color conversion helpers ///////////////////////////////////////////////
+
+    static inline float srgbToLinear(float c)
+    {
+      return c <= 0.04045f ? c / 12.92f :
+                             ospcommon::fast_pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static inline float linearToSrgb(float c)
+    {
+      return c <= 0.0031308f ? c * 12.92f :
+             1.055f * ospcommon::fast_pow(c, 1.f / 2.4f) - 0.055f;
+    }
+
+    static inline uint32 toByte(float c)
+    {
+      return uint32(ospcommon::clamp(c, 0.f, 1.f) * 255.f + .5f);
+    }
+
+    // Denoiser definitions ///////////////////////////////////////////////////
+
+    void Denoiser::commit(ManagedObject &renderer)
+    {
+      settings.enable      = renderer.getParam1i("denoise", 0);
+      settings.iterations  = ospcommon::clamp(
+                               renderer.getParam1i("denoiseIterations", 3),
+                               1, 5);
+      settings.depthSigma  = renderer.getParam1f("denoiseDepthSigma", 0.1f);
+      settings.normalPower = renderer.getParam1f("denoiseNormalPower", 64.f);
+      settings.albedoSigma = renderer.getParam1f("denoiseAlbedoSigma", 0.1f);
+    }
+
+    void Denoiser::beginFrame(const FrameBuffer *fb)
+    {
+      if (!enabled())
+        return;
+
+      // NOTE(jda) - the widest kernel reaches 2 * 2^(iterations-1) pixels
+      //             to each side, the right padding also rounds rows up to
+      //             whole SIMD vectors
+      const int newPadding = 1 << settings.iterations;
+      const int rowWidth   = (fb->size.x + simd::width - 1) /
+                             simd::width * simd::width;
+      const int newStride  = rowWidth + 2 * newPadding;
+
+      if (fb->size != size || newStride != stride) {
+        size    = fb->size;
+        padding = newPadding;
+        stride  = newStride;
+
+        const size_t n = size_t(stride) * size.y;
+
+        for (auto *guide : {&nx, &ny, &nz, &ar, &ag, &ab})
+          guide->assign(n, 0.f);
+
+        for (int i = 0; i < 2; ++i) {
+          r[i].assign(n, 0.f);
+          g[i].assign(n, 0.f);
+          b[i].assign(n, 0.f);
+        }
+      }
+
+      // NOTE(jda) - pixels (and padding) not written by a renderer this frame
+      //             are treated as background
+      depth.assign(size_t(stride) * size.y, inf);
+    }
+
+    void Denoiser::endFrame(FrameBuffer *fb)
+    {
+      if (!enabled() || fb->size != size)
+        return;
+
+      auto *localFB = dynamic_cast<LocalFrameBuffer*>(fb);
+
+      if (localFB == nullptr || localFB->colorBuffer == nullptr)
+        return;
+
+      readColors(fb);
+
+      int src = 0;
+
+      for (int i = 0; i < settings.iterations; ++i) {
+        const int dst = 1 - src;
+
+        tasking::parallel_for(size.y, [&](int y) {
+          filterRow(y, 1 << i, src, dst);
+        });
+
+        src = dst;
+      }
+
+      if (src != 0) {
+        std::swap(r[0], r[1]);
+        std::swap(g[0], g[1]);
+        std::swap(b[0], b[1]);
+      }
+
+      writeColors(fb);
+    }
+
+    void Denoiser::readColors(const FrameBuffer *fb)
+    {
+      auto *localFB = dynamic_cast<const LocalFrameBuffer*>(fb);
+      const auto format = fb->colorBufferFormat;
+
+      tasking::parallel_for(size.y, [&](int y) {
+        for (int x = 0; x < size.x; ++x) {
+          const int i = index(x, y);
+          const int p = y * size.x + x;
+
+          vec3f c;
+
+          if (format == OSP_FB_RGBA32F) {
+            const auto &rgba = ((const vec4f*)localFB->colorBuffer)[p];
+            c = vec3f(rgba.x, rgba.y, rgba.z);
+          } else {
+            const uint32 rgba = ((const uint32*)localFB->colorBuffer)[p];
+            c = vec3f((rgba >>  0) & 0xff,
+                      (rgba >>  8) & 0xff,
+                      (rgba >> 16) & 0xff) * (1.f / 255.f);
+            if (format == OSP_FB_SRGBA) {
+              c = vec3f(srgbToLinear(c.x),
+                        srgbToLinear(c.y),
+                        srgbToLinear(c.z));
+            }
+          }
+
+          r[0][i] = c.x;
+          g[0][i] = c.y;
+          b[0][i] = c.z;
+        }
+      });
+    }
+
+    void Denoiser::writeColors(FrameBuffer *fb) const
+    {
+      auto *localFB = dynamic_cast<LocalFrameBuffer*>(fb);
+      const auto format = fb->colorBufferFormat;
+
+      tasking::parallel_for(size.y, [&](int y) {
+        for (int x = 0; x < size.x; ++x) {
+          const int i = index(x, y);
+          const int p = y * size.x + x;
+
+          if (format == OSP_FB_RGBA32F) {
+            auto &rgba = ((vec4f*)localFB->colorBuffer)[p];
+            rgba.x = r[0][i];
+            rgba.y = g[0][i];
+            rgba.z = b[0][i];
+          } else {
+            auto &rgba = ((uint32*)localFB->colorBuffer)[p];
+            vec3f c(r[0][i], g[0][i], b[0][i]);
+            if (format == OSP_FB_SRGBA) {
+              c = vec3f(linearToSrgb(c.x),
+                        linearToSrgb(c.y),
+                        linearToSrgb(c.z));
+            }
+            rgba = (rgba & 0xff000000) |
+                   toByte(c.x) | (toByte(c.y) << 8) | (toByte(c.z) << 16);
+          }
+        }
+      });
+    }
+
+    void Denoiser::filterRow(int y, int step, int src, int dst)
+    {
+      using simd::vfloat;
+
+      static const float h[5] = {1.f/16.f, 1.f/4.f, 3.f/8.f, 1.f/4.f, 1.f/16.f};
+
+      const vfloat background {float(inf)};
+
+      const float rcpDepthSigma  = 1.f / settings.depthSigma;
+      const float rcpAlbedoSigma = 1.f / settings.albedoSigma;
+
+      const float *srcR = r[src].data();
+      const float *srcG = g[src].data();
+      const float *srcB = b[src].data();
+
+      for (int x = 0; x < size.x; x += simd::width) {
+        const int p = index(x, y);
+
+        const vfloat pz  = vfloat::loadu(&depth[p]);
+        const vfloat pnx = vfloat::loadu(&nx[p]);
+        const vfloat pny = vfloat::loadu(&ny[p]);
+        const vfloat pnz = vfloat::loadu(&nz[p]);
+        const vfloat par = vfloat::loadu(&ar[p]);
+        const vfloat pag = vfloat::loadu(&ag[p]);
+        const vfloat pab = vfloat::loadu(&ab[p]);
+
+        const auto pValid = pz < background;
+        const vfloat rcpDepth = rcpDepthSigma / simd::select(pValid, pz, 1.f);
+
+        vfloat sumR {0.f}, sumG {0.f}, sumB {0.f}, sumW {0.f};
+
+        for (int j = -2; j <= 2; ++j) {
+          const int qy = y + j * step;
+          if (qy < 0 || qy >= size.y)
+            continue;
+
+          for (int i = -2; i <= 2; ++i) {
+            const int q = index(x + i * step, qy);
+
+            const vfloat qz = vfloat::loadu(&depth[q]);
+
+            // NOTE(jda) - padding and background pixels have infinite depth
+            const auto qValid = pValid & (qz < background);
+
+            if (simd::none(qValid))
+              continue;
+
+            const vfloat dz = simd::abs(qz - pz) * rcpDepth;
+
+            const vfloat dar = vfloat::loadu(&ar[q]) - par;
+            const vfloat dag = vfloat::loadu(&ag[q]) - pag;
+            const vfloat dab = vfloat::loadu(&ab[q]) - pab;
+            const vfloat da2 = (dar*dar + dag*dag + dab*dab) *
+                               (rcpAlbedoSigma * rcpAlbedoSigma);
+
+            const vfloat cosN = vfloat::loadu(&nx[q]) * pnx +
+                                vfloat::loadu(&ny[q]) * pny +
+                                vfloat::loadu(&nz[q]) * pnz;
+
+            vfloat w = (h[i+2] * h[j+2]) * simd::exp(-(dz*dz + da2)) *
+                       simd::pow(cosN, settings.normalPower);
+            w = simd::select(qValid, w, 0.f);
+
+            sumR += w * vfloat::loadu(&srcR[q]);
+            sumG += w * vfloat::loadu(&srcG[q]);
+            sumB += w * vfloat::loadu(&srcB[q]);
+            sumW += w;
+          }
+        }
+
+        // NOTE(jda) - the center tap always has weight h[2]*h[2] for valid
+        //             pixels, background pixels are copied
+        const auto filtered = pValid & (sumW > 0.f);
+        const vfloat rcpW   = 1.f / simd::select(filtered, sumW, 1.f);
+
+        vfloat::storeu(&r[dst][p], simd::select(filtered, sumR * rcpW,
+                                                vfloat::loadu(&srcR[p])));
+        vfloat::storeu(&g[dst][p], simd::select(filtered, sumG * rcpW,
+                                                vfloat::loadu(&srcG[p])));
+        vfloat::storeu(&b[dst][p], simd::select(filtered, sumB * rcpW,
+                                                vfloat::loadu(&srcB[p])));
+      }
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
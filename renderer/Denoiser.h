@@ -0,0 +1,128 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "common/Managed.h"
+#include "fb/FrameBuffer.h"
+// ospray_cpp
+#include "../common/simd.h"
+// std
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief edge-aware a-trous wavelet filter for noisy (low sample count)
+     *         frames
+
+        Renderers write per-pixel guides (depth, normal, albedo) while
+        shading with setGuides(); after all tiles are done the filter runs
+        over the frame buffer's color buffer. Each iteration is a 5x5
+        B3-spline kernel with holes (taps 2^i pixels apart), whose weights
+        are attenuated by differences in relative depth, normal and albedo,
+        so geometric and texture edges are preserved. Pixels without guides
+        (background) are neither filtered nor used as taps.
+
+        All buffers are planar and padded horizontally, so one row is
+        filtered simd::width pixels at a time without border handling. */
+    struct Denoiser
+    {
+      /*! \brief read the 'denoise*' parameters of 'renderer' */
+      void commit(ManagedObject &renderer);
+
+      bool enabled() const;
+
+      /*! \brief (re)allocate the guide buffers for 'fb' and clear them */
+      void beginFrame(const FrameBuffer *fb);
+
+      /*! \brief filter the color buffer of 'fb' (a LocalFrameBuffer) */
+      void endFrame(FrameBuffer *fb);
+
+      /*! \brief store the guides of pixel (x, y), called by renderers while
+       *         shading (so const), each pixel by one thread only */
+      void setGuides(int x, int y,
+                     float depth,
+                     const vec3f &normal,
+                     const vec3f &albedo) const;
+
+    private:
+
+      int index(int x, int y) const;
+
+      void readColors(const FrameBuffer *fb);
+      void writeColors(FrameBuffer *fb) const;
+
+      //! \brief filter row 'y' of 'src' into 'dst', taps 'step' pixels apart
+      void filterRow(int y, int step, int src, int dst);
+
+      // Data //
+
+      struct Settings
+      {
+        bool  enable {false};
+        int   iterations {3};
+        float depthSigma {0.1f};  //!< relative to the center pixel's depth
+        float normalPower {64.f};
+        float albedoSigma {0.1f};
+      };
+
+      Settings settings;
+
+      vec2i size {0};
+      int   padding {0};
+      int   stride {0};
+
+      // NOTE(jda) - guides are written from const shading code, they are
+      //             only (re)allocated in beginFrame()
+      mutable std::vector<float> depth;
+      mutable std::vector<float> nx, ny, nz;
+      mutable std::vector<float> ar, ag, ab;
+
+      //! ping-pong color buffers
+      std::vector<float> r[2], g[2], b[2];
+    };
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline bool Denoiser::enabled() const
+    {
+      return settings.enable;
+    }
+
+    inline int Denoiser::index(int x, int y) const
+    {
+      return y * stride + padding + x;
+    }
+
+    inline void Denoiser::setGuides(int x, int y,
+                                    float d,
+                                    const vec3f &normal,
+                                    const vec3f &albedo) const
+    {
+      const int i = index(x, y);
+      depth[i] = d;
+      nx[i] = normal.x;
+      ny[i] = normal.y;
+      nz[i] = normal.z;
+      ar[i] = albedo.x;
+      ag[i] = albedo.y;
+      ab[i] = albedo.z;
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,94 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "MaterialTable.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    void MaterialTable::clear()
+    {
+      Kd_x.clear(); Kd_y.clear(); Kd_z.clear();
+      Ks_x.clear(); Ks_y.clear(); Ks_z.clear();
+      Ns_v.clear();
+      d_v.clear();
+      map_Kd_v.clear(); map_Ks_v.clear(); map_Ns_v.clear(); map_d_v.clear();
+      geometries.clear();
+    }
+
+    void MaterialTable::add(const Entry &entry)
+    {
+      Kd_x.push_back(entry.Kd.x);
+      Kd_y.push_back(entry.Kd.y);
+      Kd_z.push_back(entry.Kd.z);
+      Ks_x.push_back(entry.Ks.x);
+      Ks_y.push_back(entry.Ks.y);
+      Ks_z.push_back(entry.Ks.z);
+      Ns_v.push_back(entry.Ns);
+      d_v.push_back(entry.d);
+      map_Kd_v.push_back(entry.map_Kd);
+      map_Ks_v.push_back(entry.map_Ks);
+      map_Ns_v.push_back(entry.map_Ns);
+      map_d_v.push_back(entry.map_d);
+    }
+
+    simd::vint MaterialTable::lookup(simd::vmaski active,
+                                     const simd::vint &geomID,
+                                     const simd::vint &primID) const
+    {
+      // NOTE(jda) - the per-primitive index arrays are owned by each
+      //             geometry, so only the final table fetches are gathers
+      simd::vint id {0};
+
+      simd::foreach_active(active, [&](int i) {
+        id[i] = lookup(geomID[i], primID[i]);
+      });
+
+      return id;
+    }
+
+    simd::vec4f MaterialTable::map_Kd(simd::vmaski active,
+                                      const simd::vint &id,
+                                      const simd::vec2f &st,
+                                      const simd::vfloat &width) const
+    {
+      simd::vec4f result {simd::vfloat{1.f}};
+
+      // NOTE(jda) - lanes hitting the same material are sampled together,
+      //             one SIMD lookup per distinct textured material
+      auto pending = active;
+
+      for (int i = 0; i < simd::width; ++i) {
+        if (!pending[i])
+          continue;
+
+        const auto sameMaterial = pending & (id == simd::vint(id[i]));
+        pending = pending & !sameMaterial;
+
+        const auto *tex = map_Kd(id[i]);
+
+        if (tex) {
+          result = simd::select(sameMaterial,
+                                tex->sample(sameMaterial, st, width),
+                                result);
+        }
+      }
+
+      return result;
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,257 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "common/Model.h"
+// ospray_cpp
+#include "../common/simd.h"
+#include "../geometry/Geometry.h"
+#include "../texture/MipMapTexture.h"
+// std
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief flat (SoA) copy of the material parameters of all materials
+     *         referenced by a model, indexed by a dense material ID
+
+        Each renderer defines its own material type, so the table is built
+        by the renderer (in commit()) with a function converting one of its
+        materials into an Entry. Dense IDs are assigned per geometry: the
+        materials of geometry 'g' occupy [base(g), base(g)+numMaterials(g)),
+        and ID 0 is the renderer's fallback entry (used for missing or
+        foreign materials and for geometry the table doesn't know about). */
+    struct MaterialTable
+    {
+      struct Entry
+      {
+        vec3f Kd {1.f};
+        vec3f Ks {0.f};
+        float Ns {0.f};
+        float d  {1.f};
+
+        std::shared_ptr<const MipMapTexture> map_Kd;
+        std::shared_ptr<const MipMapTexture> map_Ks;
+        std::shared_ptr<const MipMapTexture> map_Ns;
+        std::shared_ptr<const MipMapTexture> map_d;
+      };
+
+      /*! \brief rebuild the table, 'convert(const ospray::Material *, Entry&)'
+       *         fills in the entry of a material (which is initialized to
+       *         'fallback') and is only called for non-null materials */
+      template <typename CONVERT_FCN>
+      void build(const Model *model, const Entry &fallback,
+                 CONVERT_FCN &&convert);
+
+      void clear();
+      bool empty() const;
+      int  size() const;
+
+      // Dense ID lookup //
+
+      int lookup(int geomID, int primID) const;
+
+      simd::vint lookup(simd::vmaski active,
+                        const simd::vint &geomID,
+                        const simd::vint &primID) const;
+
+      // Parameter access //
+
+      //! \brief parameters of material 'id', without its textures (map_*())
+      Entry get(int id) const;
+      float d(int id) const;
+
+      const MipMapTexture *map_Kd(int id) const;
+      const MipMapTexture *map_Ks(int id) const;
+      const MipMapTexture *map_Ns(int id) const;
+      const MipMapTexture *map_d (int id) const;
+
+      simd::vec3f  Kd(simd::vmaski active, const simd::vint &id) const;
+      simd::vec3f  Ks(simd::vmaski active, const simd::vint &id) const;
+      simd::vfloat Ns(simd::vmaski active, const simd::vint &id) const;
+      simd::vfloat d (simd::vmaski active, const simd::vint &id) const;
+
+      /*! \brief map_Kd lookup for each lane, (1,1,1,1) for lanes whose
+       *         material has no map_Kd */
+      simd::vec4f map_Kd(simd::vmaski active,
+                         const simd::vint &id,
+                         const simd::vec2f &st,
+                         const simd::vfloat &width) const;
+
+    private:
+
+      void add(const Entry &entry);
+
+      struct GeometryInfo
+      {
+        int base {0};
+        int numMaterials {0};
+        int geomMaterialIndex {0};
+        const uint32 *primMaterialIndices {nullptr};
+      };
+
+      // Data //
+
+      std::vector<float> Kd_x, Kd_y, Kd_z;
+      std::vector<float> Ks_x, Ks_y, Ks_z;
+      std::vector<float> Ns_v;
+      std::vector<float> d_v;
+
+      std::vector<std::shared_ptr<const MipMapTexture>> map_Kd_v;
+      std::vector<std::shared_ptr<const MipMapTexture>> map_Ks_v;
+      std::vector<std::shared_ptr<const MipMapTexture>> map_Ns_v;
+      std::vector<std::shared_ptr<const MipMapTexture>> map_d_v;
+
+      //! indexed by embree geometry ID (== index into model->geometry)
+      std::vector<GeometryInfo> geometries;
+    };
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    template <typename CONVERT_FCN>
+    inline void MaterialTable::build(const Model *model,
+                                     const Entry &fallback,
+                                     CONVERT_FCN &&convert)
+    {
+      clear();
+      add(fallback);
+
+      if (model == nullptr)
+        return;
+
+      geometries.resize(model->geometry.size());
+
+      for (size_t g = 0; g < model->geometry.size(); ++g) {
+        auto *geom = dynamic_cast<Geometry*>(model->geometry[g].ptr);
+
+        if (geom == nullptr)
+          continue;
+
+        auto &info = geometries[g];
+
+        info.base                = size();
+        info.numMaterials        = geom->numMaterials();
+        info.geomMaterialIndex   = geom->geomMaterialIndex();
+        info.primMaterialIndices = geom->primMaterialIndices();
+
+        for (int i = 0; i < info.numMaterials; ++i) {
+          Entry entry = fallback;
+          const auto *mat = geom->getMaterial(i);
+          if (mat)
+            convert(mat, entry);
+          add(entry);
+        }
+      }
+    }
+
+    inline bool MaterialTable::empty() const
+    {
+      return d_v.empty();
+    }
+
+    inline int MaterialTable::size() const
+    {
+      return static_cast<int>(d_v.size());
+    }
+
+    inline int MaterialTable::lookup(int geomID, int primID) const
+    {
+      if (geomID < 0 || geomID >= static_cast<int>(geometries.size()))
+        return 0;
+
+      const auto &info = geometries[geomID];
+
+      if (info.numMaterials == 0)
+        return 0;
+
+      int local = info.primMaterialIndices ?
+                  int(info.primMaterialIndices[primID]) :
+                  info.geomMaterialIndex;
+
+      if (local < 0 || local >= info.numMaterials)
+        local = 0;
+
+      return info.base + local;
+    }
+
+    inline MaterialTable::Entry MaterialTable::get(int id) const
+    {
+      Entry e;
+      e.Kd = vec3f(Kd_x[id], Kd_y[id], Kd_z[id]);
+      e.Ks = vec3f(Ks_x[id], Ks_y[id], Ks_z[id]);
+      e.Ns = Ns_v[id];
+      e.d  = d_v[id];
+      return e;
+    }
+
+    inline float MaterialTable::d(int id) const
+    {
+      return d_v[id];
+    }
+
+    inline const MipMapTexture *MaterialTable::map_Kd(int id) const
+    {
+      return map_Kd_v[id].get();
+    }
+
+    inline const MipMapTexture *MaterialTable::map_Ks(int id) const
+    {
+      return map_Ks_v[id].get();
+    }
+
+    inline const MipMapTexture *MaterialTable::map_Ns(int id) const
+    {
+      return map_Ns_v[id].get();
+    }
+
+    inline const MipMapTexture *MaterialTable::map_d(int id) const
+    {
+      return map_d_v[id].get();
+    }
+
+    inline simd::vec3f MaterialTable::Kd(simd::vmaski active,
+                                         const simd::vint &id) const
+    {
+      return {simd::vfloat::gather(active, Kd_x.data(), id),
+              simd::vfloat::gather(active, Kd_y.data(), id),
+              simd::vfloat::gather(active, Kd_z.data(), id)};
+    }
+
+    inline simd::vec3f MaterialTable::Ks(simd::vmaski active,
+                                         const simd::vint &id) const
+    {
+      return {simd::vfloat::gather(active, Ks_x.data(), id),
+              simd::vfloat::gather(active, Ks_y.data(), id),
+              simd::vfloat::gather(active, Ks_z.data(), id)};
+    }
+
+    inline simd::vfloat MaterialTable::Ns(simd::vmaski active,
+                                          const simd::vint &id) const
+    {
+      return simd::vfloat::gather(active, Ns_v.data(), id);
+    }
+
+    inline simd::vfloat MaterialTable::d(simd::vmaski active,
+                                         const simd::vint &id) const
+    {
+      return simd::vfloat::gather(active, d_v.data(), id);
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -16,6 +16,7 @@
 
 // ospray
 #include "Renderer.h"
+#include "../camera/Perspective.h"
 #include "../util.h"
 
 #include <random>
@@ -36,97 +37,123 @@ namespace ospray {
       currentCamera = dynamic_cast<Camera*>(getParamObject("camera"));
       bgColor       = getParam3f("bgColor", vec3f(1.f));
       precomputeZOrder();
+      denoiser.commit(*this);
     }
 
     void *Renderer::beginFrame(FrameBuffer *fb)
     {
       currentFB = fb;
       fb->beginFrame();
+      denoiser.beginFrame(fb);
 
       if (currentCamera == nullptr) {
         throw std::runtime_error("You are using a C++ only renderer without"
                                  " using a C++ only camera!");
       }
 
+      auto *perspective = dynamic_cast<PerspectiveCamera*>(currentCamera);
+      pixelSpread = perspective ?
+          2.f * tanf(perspective->fovy * float(M_PI / 360.0)) / fb->size.y :
+          0.f;
+
       return nullptr;
     }
 
     void Renderer::renderTile(void *perFrameData,Tile &tile,size_t jobID) const
     {
-      const float spp_inv = 1.f / spp;
-
       const auto begin = jobID * RENDERTILE_PIXELS_PER_JOB;
       const auto end   = begin + RENDERTILE_PIXELS_PER_JOB;
+
+      for (auto i = begin; i < end; ++i) {
+        for (int s = 0; s < spp; s++) {
+          ScreenSample screenSample;
+
+          if (!generateSample(tile, i, s, screenSample))
+            break;
+
+          renderSample(perFrameData, screenSample);
+          writeSample(tile, i, screenSample);
+        }
+      }
+    }
+
+    bool Renderer::generateSample(const Tile &tile,
+                                  size_t i,
+                                  int s,
+                                  ScreenSample &screenSample) const
+    {
       const auto startSampleID = ospcommon::max(tile.accumID, 0)*spp;
 
       static std::uniform_real_distribution<float> distribution {0.f, 1.f};
 
-      for (auto i = begin; i < end; ++i) {
-        ScreenSample screenSample;
-        screenSample.sampleID.x = tile.region.lower.x + z_order.xs[i];
-        screenSample.sampleID.y = tile.region.lower.y + z_order.ys[i];
-        screenSample.sampleID.z = startSampleID;
+      screenSample.sampleID.x = tile.region.lower.x + z_order.xs[i];
+      screenSample.sampleID.y = tile.region.lower.y + z_order.ys[i];
+      screenSample.sampleID.z = startSampleID+s;
 
-        auto &sampleID = screenSample.sampleID;
+      auto &sampleID = screenSample.sampleID;
 
-        if ((sampleID.x >= currentFB->size.x) ||
-            (sampleID.y >= currentFB->size.y))
-          continue;
+      if ((sampleID.x >= currentFB->size.x) ||
+          (sampleID.y >= currentFB->size.y))
+        return false;
 
-        float tMax = inf;
+      float tMax = inf;
 #if 0
-        // set ray t value for early ray termination if we have a maximum depth
-        // texture
-        if (self->maxDepthTexture) {
-          // always sample center of pixel
-          vec2f depthTexCoord;
-          depthTexCoord.x = (screenSample.sampleID.x + 0.5f) * fb->rcpSize.x;
-          depthTexCoord.y = (screenSample.sampleID.y + 0.5f) * fb->rcpSize.y;
-
-          tMax = min(get1f(self->maxDepthTexture, depthTexCoord), infinity);
-        }
+      // set ray t value for early ray termination if we have a maximum depth
+      // texture
+      if (self->maxDepthTexture) {
+        // always sample center of pixel
+        vec2f depthTexCoord;
+        depthTexCoord.x = (screenSample.sampleID.x + 0.5f) * fb->rcpSize.x;
+        depthTexCoord.y = (screenSample.sampleID.y + 0.5f) * fb->rcpSize.y;
+
+        tMax = min(get1f(self->maxDepthTexture, depthTexCoord), infinity);
+      }
 #endif
 
-        for (int s = 0; s < spp; s++) {
-          float pixel_du = distribution(generator);
-          float pixel_dv = distribution(generator);
-          screenSample.sampleID.z = startSampleID+s;
+      float pixel_du = distribution(generator);
+      float pixel_dv = distribution(generator);
 
-          CameraSample cameraSample;
-          cameraSample.screen.x = (screenSample.sampleID.x + pixel_du) *
-                                  rcp(float(currentFB->size.x));
-          cameraSample.screen.y = (screenSample.sampleID.y + pixel_dv) *
-                                  rcp(float(currentFB->size.y));
+      CameraSample cameraSample;
+      cameraSample.screen.x = (screenSample.sampleID.x + pixel_du) *
+                              rcp(float(currentFB->size.x));
+      cameraSample.screen.y = (screenSample.sampleID.y + pixel_dv) *
+                              rcp(float(currentFB->size.y));
 
-          cameraSample.lens.x = distribution(generator);
-          cameraSample.lens.y = distribution(generator);
+      cameraSample.lens.x = distribution(generator);
+      cameraSample.lens.y = distribution(generator);
 
-          auto &ray = screenSample.ray;
-          currentCamera->getRay(cameraSample, ray);
-          ray.t = tMax;
+      auto &ray = screenSample.ray;
+      currentCamera->getRay(cameraSample, ray);
+      ray.t = tMax;
 
-          renderSample(perFrameData, screenSample);
+      return true;
+    }
+
+    void Renderer::writeSample(Tile &tile,
+                               size_t i,
+                               ScreenSample &screenSample) const
+    {
+      const float spp_inv = 1.f / spp;
 
-          auto &rgb   = screenSample.rgb;
-          auto &z     = screenSample.z;
-          auto &alpha = screenSample.alpha;
+      auto &rgb   = screenSample.rgb;
+      auto &z     = screenSample.z;
+      auto &alpha = screenSample.alpha;
 
-          rgb *= spp_inv;
+      rgb *= spp_inv;
 
-          const auto pixel = z_order.xs[i] + (z_order.ys[i] * TILE_SIZE);
-          tile.r[pixel] = rgb.x;
-          tile.g[pixel] = rgb.y;
-          tile.b[pixel] = rgb.z;
-          tile.a[pixel] = alpha;
-          tile.z[pixel] = z;
-        }
-      }
+      const auto pixel = z_order.xs[i] + (z_order.ys[i] * TILE_SIZE);
+      tile.r[pixel] = rgb.x;
+      tile.g[pixel] = rgb.y;
+      tile.b[pixel] = rgb.z;
+      tile.a[pixel] = alpha;
+      tile.z[pixel] = z;
     }
 
     void Renderer::endFrame(void *perFrameData, const int32 fbChannelFlags)
     {
       UNUSED(perFrameData, fbChannelFlags);
       // NOTE(jda) - override to *not* run default behavior
+      denoiser.endFrame(currentFB);
     }
 
   }// namespace cpp_renderer
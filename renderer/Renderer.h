@@ -23,8 +23,12 @@
 
 #include "../camera/Camera.h"
 #include "../common/DifferentialGeometry.h"
+#include "../common/RayN.h"
 #include "../common/ScreenSample.h"
 #include "../geometry/Geometry.h"
+#include "Denoiser.h"
+#include "MaterialTable.h"
+#include "TransparentShadows.h"
 
 namespace ospray {
   namespace cpp_renderer {
@@ -48,14 +52,57 @@ namespace ospray {
 
     protected:
 
+      /*! \brief set up sample 's' of pixel 'i' (index into the tile's
+       *         z-order) and generate its camera ray, returns false if the
+       *         pixel lies outside of the frame buffer */
+      bool generateSample(const Tile &tile,
+                          size_t i,
+                          int s,
+                          ScreenSample &screenSample) const;
+
+      //! \brief store a rendered sample of pixel 'i' in the tile
+      void writeSample(Tile &tile, size_t i, ScreenSample &screenSample) const;
+
       bool traceRay(Ray &ray) const;
       bool isOccluded(Ray &ray) const;
 
+      /*! \brief fraction of light reaching the origin of 'shadowRay' through
+       *         (partially) transparent occluders, 0 once less than
+       *         'minContribution' of 'maxContribution' would get through */
+      float lightAlpha(Ray &shadowRay,
+                       float maxContribution,
+                       float minContribution = .01f) const;
+
+      // NOTE(jda) - packet variants are here (and not in SimdRenderer) so
+      //             scalar renderers can trace coherent secondary rays, such
+      //             as the AO rays of one hit point, as a packet
+      simd::vmaski traceRay(simd::vmaski active, RayN &ray) const;
+      simd::vmaski isOccluded(simd::vmaski active, RayN &ray) const;
+
       DifferentialGeometry postIntersect(const Ray &ray, int flags) const;
 
       vec3f bgColor;
 
       ospray::cpp_renderer::Camera *currentCamera {nullptr};
+
+      /*! \brief angle covered by one pixel of the current frame (0 if the
+       *         camera isn't perspective), the spread of a ray's footprint
+       *         used to pick texture mip levels */
+      float pixelSpread {0.f};
+
+      //! material parameters by dense ID, built by the renderer in commit()
+      MaterialTable materialTable;
+
+      //! optional post-process, renderers supporting it write its guides
+      Denoiser denoiser;
+
+    private:
+
+      template <int SIMD_W>
+      simd::vmaski traceRayImpl(simd::vmaski active, RayN &ray) const;
+
+      template <int SIMD_W>
+      simd::vmaski isOccludedImpl(simd::vmaski active, RayN &ray) const;
     };
 
     // Inlined member functions ///////////////////////////////////////////////
@@ -72,6 +119,133 @@ namespace ospray {
       return ray.hitSomething();
     }
 
+    inline float Renderer::lightAlpha(Ray &shadowRay,
+                                      float maxContribution,
+                                      float minContribution) const
+    {
+      if (materialTable.empty())
+        return isOccluded(shadowRay) ? 0.f : 1.f;
+
+#if USE_EMBREE_STREAMS
+      ShadowTransmission state;
+      state.materials       = &materialTable;
+      state.minTransmission = minContribution / maxContribution;
+
+      // NOTE(jda) - one occlusion query, transparent hits are skipped by
+      //             transparentShadowFilter() instead of re-tracing from them
+      RTCIntersectContext ctx{RTC_INTERSECT_INCOHERENT, &state};
+      rtcOccluded1M(model->embreeSceneHandle, &ctx,
+                    reinterpret_cast<RTCRay*>(&shadowRay), 1, sizeof(Ray));
+
+      return shadowRay.hitSomething() ? 0.f : state.transmission;
+#else
+      // NOTE(jda) - no intersection contexts (and so no filter state), walk
+      //             the occluders front to back, re-tracing from each
+      //             transparent hit
+      const float minTransmission = minContribution / maxContribution;
+      const float tEnd = shadowRay.t;
+
+      float transmission = 1.f;
+
+      while (true) {
+        shadowRay.t      = tEnd;
+        shadowRay.geomID = RTC_INVALID_GEOMETRY_ID;
+        shadowRay.primID = RTC_INVALID_GEOMETRY_ID;
+        shadowRay.instID = RTC_INVALID_GEOMETRY_ID;
+
+        if (!traceRay(shadowRay))
+          return transmission;
+
+        // NOTE(jda) - instances aren't in the table, use the fallback
+        const int id = shadowRay.instID < 0 ?
+            materialTable.lookup(shadowRay.geomID, shadowRay.primID) : 0;
+
+        transmission *= 1.f - materialTable.d(id);
+
+        if (transmission < minTransmission)
+          return 0.f;
+
+        shadowRay.t0 = shadowRay.t + epsilon;
+      }
+#endif
+    }
+
+    // Packet traceRay() definitions //
+
+    template <>
+    inline simd::vmaski
+    Renderer::traceRayImpl<4>(simd::vmaski active, RayN &ray) const
+    {
+      rtcIntersect4(reinterpret_cast<int*>(&active),
+                    model->embreeSceneHandle,
+                    reinterpret_cast<RTCRay4&>(ray));
+      return ray.hitSomething();
+    }
+
+    template <>
+    inline simd::vmaski
+    Renderer::traceRayImpl<8>(simd::vmaski active, RayN &ray) const
+    {
+      rtcIntersect8(reinterpret_cast<int*>(&active),
+                    model->embreeSceneHandle,
+                    reinterpret_cast<RTCRay8&>(ray));
+      return ray.hitSomething();
+    }
+
+    template <>
+    inline simd::vmaski
+    Renderer::traceRayImpl<16>(simd::vmaski active, RayN &ray) const
+    {
+      rtcIntersect16(reinterpret_cast<int*>(&active),
+                     model->embreeSceneHandle,
+                     reinterpret_cast<RTCRay16&>(ray));
+      return ray.hitSomething();
+    }
+
+    inline simd::vmaski
+    Renderer::traceRay(simd::vmaski active, RayN &ray) const
+    {
+      return traceRayImpl<simd::width>(active, ray);
+    }
+
+    // Packet isOccluded() definitions //
+
+    template <>
+    inline simd::vmaski
+    Renderer::isOccludedImpl<4>(simd::vmaski active, RayN &ray) const
+    {
+      rtcOccluded4(reinterpret_cast<int*>(&active),
+                   model->embreeSceneHandle,
+                   reinterpret_cast<RTCRay4&>(ray));
+      return ray.hitSomething();
+    }
+
+    template <>
+    inline simd::vmaski
+    Renderer::isOccludedImpl<8>(simd::vmaski active, RayN &ray) const
+    {
+      rtcOccluded8(reinterpret_cast<int*>(&active),
+                   model->embreeSceneHandle,
+                   reinterpret_cast<RTCRay8&>(ray));
+      return ray.hitSomething();
+    }
+
+    template <>
+    inline simd::vmaski
+    Renderer::isOccludedImpl<16>(simd::vmaski active, RayN &ray) const
+    {
+      rtcOccluded16(reinterpret_cast<int*>(&active),
+                    model->embreeSceneHandle,
+                    reinterpret_cast<RTCRay16&>(ray));
+      return ray.hitSomething();
+    }
+
+    inline simd::vmaski
+    Renderer::isOccluded(simd::vmaski active, RayN &ray) const
+    {
+      return isOccludedImpl<simd::width>(active, ray);
+    }
+
     inline DifferentialGeometry Renderer::postIntersect(const Ray &ray,
                                                         int flags) const
     {
@@ -138,6 +312,9 @@ namespace ospray {
 #undef  DG_NG_NORMALIZE
 #undef  DG_NS_NORMALIZE
 
+      if (flags & DG_TEXCOORD)
+        dg.stWidth = ray.t * pixelSpread * dg.stScale;
+
       return dg;
     }
 
@@ -16,6 +16,7 @@
 
 // ospray
 #include "SimdRenderer.h"
+#include "../camera/PerspectiveN.h"
 #include "../util.h"
 
 #define USE_RANDOMTEA_RNG 0
@@ -46,6 +47,11 @@ namespace ospray {
                                  " using a C++ simd camera!");
       }
 
+      auto *perspective = dynamic_cast<PerspectiveCameraN*>(currentCameraN);
+      pixelSpread = perspective ?
+          2.f * tanf(perspective->fovy * float(M_PI / 360.0)) / fb->size.y :
+          0.f;
+
       return nullptr;
     }
 
@@ -53,94 +59,116 @@ namespace ospray {
                                   Tile &tile,
                                   size_t jobID) const
     {
-      const float spp_inv = 1.f / spp;
-
       const auto begin = jobID * RENDERTILE_PIXELS_PER_JOB;
       const auto end   = begin + RENDERTILE_PIXELS_PER_JOB;
-      const auto startSampleID = ospcommon::max(tile.accumID, 0)*spp;
 
       for (auto i = begin; i < end; i += simd::width) {
-        ScreenSampleN screenSample;
+        for (int s = 0; s < spp; s++) {
+          ScreenSampleN screenSample;
+
+          const auto active = generateSample(tile, i, s, screenSample);
+
+          if (simd::none(active))
+            break;
+
+          renderSample(active, perFrameData, screenSample);
+          writeSample(tile, i, active, screenSample);
+        }
+      }
+    }
+
+    simd::vmaski SimdRenderer::generateSample(const Tile &tile,
+                                              size_t i,
+                                              int s,
+                                              ScreenSampleN &screenSample) const
+    {
+      const auto startSampleID = ospcommon::max(tile.accumID, 0)*spp;
 
-        auto tile_x = simd::load<simd::vint>(&z_order.xs[i]);
-        auto tile_y = simd::load<simd::vint>(&z_order.ys[i]);
+      auto tile_x = simd::load<simd::vint>(&z_order.xs[i]);
+      auto tile_y = simd::load<simd::vint>(&z_order.ys[i]);
 
-        screenSample.sampleID.x = tile.region.lower.x + tile_x;
-        screenSample.sampleID.y = tile.region.lower.y + tile_y;
-        screenSample.sampleID.z = startSampleID;
+      screenSample.sampleID.x = tile.region.lower.x + tile_x;
+      screenSample.sampleID.y = tile.region.lower.y + tile_y;
+      screenSample.sampleID.z = startSampleID + s;
 
-        const auto &sampleID = screenSample.sampleID;
+      const auto &sampleID = screenSample.sampleID;
 
-        auto active = (sampleID.x < simd::vint{currentFB->size.x}) &
-                      (sampleID.y < simd::vint{currentFB->size.y});
+      auto active = (sampleID.x < simd::vint{currentFB->size.x}) &
+                    (sampleID.y < simd::vint{currentFB->size.y});
 
-        if (simd::none(active))
-          continue;
+      if (simd::none(active))
+        return active;
 
-        float tMax = inf;
+      float tMax = inf;
 #if 0
-        // set ray t value for early ray termination if we have a maximum depth
-        // texture
-        if (self->maxDepthTexture) {
-          // always sample center of pixel
-          vec2f depthTexCoord;
-          depthTexCoord.x = (screenSample.sampleID.x + 0.5f) * fb->rcpSize.x;
-          depthTexCoord.y = (screenSample.sampleID.y + 0.5f) * fb->rcpSize.y;
-
-          tMax = min(get1f(self->maxDepthTexture, depthTexCoord), infinity);
-        }
+      // set ray t value for early ray termination if we have a maximum depth
+      // texture
+      if (self->maxDepthTexture) {
+        // always sample center of pixel
+        vec2f depthTexCoord;
+        depthTexCoord.x = (screenSample.sampleID.x + 0.5f) * fb->rcpSize.x;
+        depthTexCoord.y = (screenSample.sampleID.y + 0.5f) * fb->rcpSize.y;
+
+        tMax = min(get1f(self->maxDepthTexture, depthTexCoord), infinity);
+      }
 #endif
 
 #if USE_RANDOMTEA_RNG
-        const auto &fbWidth = currentFB->size.x;
-        const auto pixel_x = screenSample.sampleID.x;
-        const auto pixel_y = screenSample.sampleID.y;
-        const auto accumID = screenSample.sampleID.z;
-        simd::RandomTEA<simd::vint> rng((pixel_y * fbWidth) + pixel_x, accumID);
-
-        for (int s = 0; s < spp; s++) {
-          auto randDuDv = rng.getFloats();
-          auto &du = randDuDv.x;
-          auto &dv = randDuDv.y;
+      const auto &fbWidth = currentFB->size.x;
+      const auto pixel_x = screenSample.sampleID.x;
+      const auto pixel_y = screenSample.sampleID.y;
+      const auto accumID = screenSample.sampleID.z;
+      simd::RandomTEA<simd::vint> rng((pixel_y * fbWidth) + pixel_x, accumID);
+
+      auto randDuDv = rng.getFloats();
+      auto &du = randDuDv.x;
+      auto &dv = randDuDv.y;
 #else
-        for (int s = 0; s < spp; s++) {
-          auto du = simd::randUniformDist();
-          auto dv = simd::randUniformDist();
+      auto du = simd::randUniformDist();
+      auto dv = simd::randUniformDist();
 #endif
-          screenSample.sampleID.z = startSampleID + s;
 
-          CameraSampleN cameraSample;
+      CameraSampleN cameraSample;
 
-          du += simd::cast<simd::vfloat>(screenSample.sampleID.x);
-          dv += simd::cast<simd::vfloat>(screenSample.sampleID.y);
-          cameraSample.screen.x = du * (1.f / currentFB->size.x);
-          cameraSample.screen.y = dv * (1.f / currentFB->size.y);
+      du += simd::cast<simd::vfloat>(screenSample.sampleID.x);
+      dv += simd::cast<simd::vfloat>(screenSample.sampleID.y);
+      cameraSample.screen.x = du * (1.f / currentFB->size.x);
+      cameraSample.screen.y = dv * (1.f / currentFB->size.y);
 
 #if 0
-          cameraSample.lens.x = simd::randUniformDist();
-          cameraSample.lens.y = simd::randUniformDist();
+      cameraSample.lens.x = simd::randUniformDist();
+      cameraSample.lens.y = simd::randUniformDist();
 #endif
 
-          auto &ray = screenSample.ray;
-          currentCameraN->getRay(cameraSample, ray);
-          ray.t = tMax;
+      auto &ray = screenSample.ray;
+      currentCameraN->getRay(cameraSample, ray);
+      ray.t = tMax;
 
-          renderSample(active, perFrameData, screenSample);
+      return active;
+    }
 
-          auto &rgb   = screenSample.rgb;
-          auto &z     = screenSample.z;
-          auto &alpha = screenSample.alpha;
+    void SimdRenderer::writeSample(Tile &tile,
+                                   size_t i,
+                                   simd::vmaski active,
+                                   ScreenSampleN &screenSample) const
+    {
+      const float spp_inv = 1.f / spp;
 
-          rgb *= simd::vfloat{spp_inv};
+      auto tile_x = simd::load<simd::vint>(&z_order.xs[i]);
+      auto tile_y = simd::load<simd::vint>(&z_order.ys[i]);
 
-          const auto pixel = tile_x + (tile_y * TILE_SIZE);
-          simd::store(rgb.x, (float*)tile.r, pixel, active);
-          simd::store(rgb.y, (float*)tile.g, pixel, active);
-          simd::store(rgb.z, (float*)tile.b, pixel, active);
-          simd::store(alpha, (float*)tile.a, pixel, active);
-          simd::store(z    , (float*)tile.z, pixel, active);
-        }
-      }
+      auto &rgb   = screenSample.rgb;
+      auto &z     = screenSample.z;
+      auto &alpha = screenSample.alpha;
+
+      rgb *= simd::vfloat{spp_inv};
+
+      const auto pixel = tile_x + (tile_y * TILE_SIZE);
+      simd::store(rgb.x, (float*)tile.r, pixel, active);
+      simd::store(rgb.y, (float*)tile.g, pixel, active);
+      simd::store(rgb.z, (float*)tile.b, pixel, active);
+      simd::store(alpha, (float*)tile.a, pixel, active);
+      simd::store(z    , (float*)tile.z, pixel, active);
     }
 
     void SimdRenderer::renderSample(void *perFrameData,
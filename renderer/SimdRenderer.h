@@ -49,8 +49,19 @@ namespace ospray {
 
     protected:
 
-      simd::vmaski traceRay(simd::vmaski active, RayN &ray) const;
-      simd::vmaski isOccluded(simd::vmaski active, RayN &ray) const;
+      /*! \brief set up sample 's' of the packet of pixels starting at 'i'
+       *         (index into the tile's z-order) and generate its camera
+       *         rays, returns the lanes inside the frame buffer */
+      simd::vmaski generateSample(const Tile &tile,
+                                  size_t i,
+                                  int s,
+                                  ScreenSampleN &screenSample) const;
+
+      //! \brief store the 'active' lanes of a rendered packet in the tile
+      void writeSample(Tile &tile,
+                       size_t i,
+                       simd::vmaski active,
+                       ScreenSampleN &screenSample) const;
 
       DifferentialGeometryN postIntersect(simd::vmaski active,
                                           const RayN &ray,
@@ -59,96 +70,10 @@ namespace ospray {
       // Data //
 
       ospray::cpp_renderer::CameraN *currentCameraN {nullptr};
-
-    private:
-
-      template <int SIMD_W>
-      simd::vmaski traceRayImpl(simd::vmaski active, RayN &ray) const;
-
-      template <int SIMD_W>
-      simd::vmaski isOccludedImpl(simd::vmaski active, RayN &ray) const;
     };
 
     // Inlined member functions ///////////////////////////////////////////////
 
-    // traceRay() definitions //
-
-    template <>
-    inline simd::vmaski
-    SimdRenderer::traceRayImpl<4>(simd::vmaski active, RayN &ray) const
-    {
-      rtcIntersect4(reinterpret_cast<int*>(&active),
-                    model->embreeSceneHandle,
-                    reinterpret_cast<RTCRay4&>(ray));
-      return ray.hitSomething();
-    }
-
-    template <>
-    inline simd::vmaski
-    SimdRenderer::traceRayImpl<8>(simd::vmaski active, RayN &ray) const
-    {
-      rtcIntersect8(reinterpret_cast<int*>(&active),
-                    model->embreeSceneHandle,
-                    reinterpret_cast<RTCRay8&>(ray));
-      return ray.hitSomething();
-    }
-
-    template <>
-    inline simd::vmaski
-    SimdRenderer::traceRayImpl<16>(simd::vmaski active, RayN &ray) const
-    {
-      rtcIntersect16(reinterpret_cast<int*>(&active),
-                     model->embreeSceneHandle,
-                     reinterpret_cast<RTCRay16&>(ray));
-      return ray.hitSomething();
-    }
-
-    inline simd::vmaski
-    SimdRenderer::traceRay(simd::vmaski active, RayN &ray) const
-    {
-      return traceRayImpl<simd::width>(active, ray);
-    }
-
-    // isOccluded() definitions //
-
-    template <>
-    inline simd::vmaski
-    SimdRenderer::isOccludedImpl<4>(simd::vmaski active, RayN &ray) const
-    {
-      rtcOccluded4(reinterpret_cast<int*>(&active),
-                   model->embreeSceneHandle,
-                   reinterpret_cast<RTCRay4&>(ray));
-      return ray.hitSomething();
-    }
-
-    template <>
-    inline simd::vmaski
-    SimdRenderer::isOccludedImpl<8>(simd::vmaski active, RayN &ray) const
-    {
-      rtcOccluded8(reinterpret_cast<int*>(&active),
-                   model->embreeSceneHandle,
-                   reinterpret_cast<RTCRay8&>(ray));
-      return ray.hitSomething();
-    }
-
-    template <>
-    inline simd::vmaski
-    SimdRenderer::isOccludedImpl<16>(simd::vmaski active, RayN &ray) const
-    {
-      rtcOccluded16(reinterpret_cast<int*>(&active),
-                    model->embreeSceneHandle,
-                    reinterpret_cast<RTCRay16&>(ray));
-      return ray.hitSomething();
-    }
-
-    inline simd::vmaski
-    SimdRenderer::isOccluded(simd::vmaski active, RayN &ray) const
-    {
-      return isOccludedImpl<simd::width>(active, ray);
-    }
-
-    // Other Definitions //
-
     inline DifferentialGeometryN
     SimdRenderer::postIntersect(simd::vmaski active,
                                 const RayN &ray,
@@ -159,6 +84,9 @@ namespace ospray {
       if (flags & DG_COLOR)
         dg.color = simd::vec4f{simd::vfloat{1.f}};
 
+      if (flags & DG_TEXCOORD)
+        dg.st = simd::vec2f{simd::vfloat{0.f}};
+
       dg.P  = ray.org + ray.t * ray.dir;
       dg.Ng = dg.Ns = ray.Ng;
 
@@ -183,6 +111,21 @@ namespace ospray {
 #if 0
             geom->postIntersect(dg, ray, flags);
 #endif
+            // NOTE(jda) - until then, texture coordinates (and their
+            //             footprint) come from the scalar geometry per lane
+            if (flags & DG_TEXCOORD) {
+              Ray laneRay;
+              laneRay.primID = ray.primID[i];
+              laneRay.u      = ray.u[i];
+              laneRay.v      = ray.v[i];
+
+              DifferentialGeometry laneDG;
+              geom->postIntersect(laneDG, laneRay, DG_TEXCOORD);
+
+              dg.st.x[i]    = laneDG.st.x;
+              dg.st.y[i]    = laneDG.st.y;
+              dg.stWidth[i] = ray.t[i] * pixelSpread * laneDG.stScale;
+            }
           }
         });
       } else if (simd::any(instGeometry)) {
@@ -205,6 +148,12 @@ namespace ospray {
         });
       }
 
+      // NOTE(jda) - instances aren't cpp_renderer::Geometry, so they end up
+      //             with the fallback material (ID 0) just like above
+      if ((flags & DG_MATERIALID) && !materialTable.empty())
+        dg.materialID = materialTable.lookup(regularGeometry, ray.geomID,
+                                             ray.primID);
+
 #define  DG_NG_FACEFORWARD (DG_NG | DG_FACEFORWARD)
 #define  DG_NS_FACEFORWARD (DG_NS | DG_FACEFORWARD)
 #define  DG_NG_NORMALIZE   (DG_NG | DG_NORMALIZE)
@@ -0,0 +1,74 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "TransparentShadows.h"
+#include "MaterialTable.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+#if USE_EMBREE_STREAMS
+    void transparentShadowFilter(int *valid,
+                                 void *userPtr,
+                                 const RTCIntersectContext *context,
+                                 RTCRayN *ray,
+                                 const RTCHitN *potentialHit,
+                                 const size_t N)
+    {
+      UNUSED(userPtr);
+      UNUSED(ray);
+
+      auto *state = context ?
+          static_cast<ShadowTransmission*>(context->userRayExt) : nullptr;
+
+      if (state == nullptr || state->materials == nullptr)
+        return;
+
+      // NOTE(jda) - the state belongs to a single ray, embree may still hand
+      //             it to us as one valid lane of a wider packet
+      for (size_t i = 0; i < N; ++i) {
+        if (valid[i] == 0)
+          continue;
+
+        const unsigned geomID = RTCHitN_geomID(potentialHit, N, i);
+        const unsigned primID = RTCHitN_primID(potentialHit, N, i);
+        const unsigned instID = RTCHitN_instID(potentialHit, N, i);
+
+        const bool repeated = geomID == state->lastGeomID &&
+                              primID == state->lastPrimID &&
+                              instID == state->lastInstID;
+
+        if (!repeated) {
+          state->lastGeomID = geomID;
+          state->lastPrimID = primID;
+          state->lastInstID = instID;
+
+          // NOTE(jda) - instances aren't in the table, use the fallback
+          const int id = instID == RTC_INVALID_GEOMETRY_ID ?
+              state->materials->lookup(geomID, primID) : 0;
+
+          state->transmission *= 1.f - state->materials->d(id);
+        }
+
+        // reject the hit to continue the query while enough light gets through
+        if (state->transmission >= state->minTransmission)
+          valid[i] = 0;
+      }
+    }
+#endif
+
+  }// namespace cpp_renderer
+}// namespace ospray
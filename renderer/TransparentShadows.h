@@ -0,0 +1,69 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// embree
+#include "embree2/rtcore.h"
+#include "embree2/rtcore_ray.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    struct MaterialTable;
+
+    /*! \brief state of one transparent shadow query
+
+        Passed to the occlusion filter through RTCIntersectContext::userRayExt
+        of a single ray occlusion query. The filter multiplies 'transmission'
+        by (1 - d) of every occluder found along the ray and only accepts the
+        hit (terminating the query) once 'transmission' drops below
+        'minTransmission'. Occluders are not found in order, but the product
+        doesn't depend on it. Embree may report a primitive more than once
+        (it can be referenced from several leaves with spatial splits), so
+        a hit on the same primitive as the previous one is skipped.
+
+        Intersection contexts need the stream API, so without
+        USE_EMBREE_STREAMS the filter isn't installed and
+        Renderer::lightAlpha() re-traces from every transparent hit. */
+    struct ShadowTransmission
+    {
+      const MaterialTable *materials {nullptr};
+      float transmission {1.f};
+      float minTransmission {0.f};
+
+      //! last occluder applied, to skip repeated reports of it
+      unsigned lastGeomID {RTC_INVALID_GEOMETRY_ID};
+      unsigned lastPrimID {RTC_INVALID_GEOMETRY_ID};
+      unsigned lastInstID {RTC_INVALID_GEOMETRY_ID};
+    };
+
+#if USE_EMBREE_STREAMS
+    /*! \brief embree occlusion filter implementing ShadowTransmission
+
+        Installed on every TriangleMesh, occlusion queries without a
+        ShadowTransmission in their context (or without a material table)
+        see all hits as opaque. */
+    void transparentShadowFilter(int *valid,
+                                 void *userPtr,
+                                 const RTCIntersectContext *context,
+                                 RTCRayN *ray,
+                                 const RTCHitN *potentialHit,
+                                 const size_t N);
+#endif
+
+  }// namespace cpp_renderer
+}// namespace ospray
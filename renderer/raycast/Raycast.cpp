@@ -90,9 +90,17 @@ namespace ospray {
 
     OSP_REGISTER_RENDERER(RaycastRenderer, cpp_raycast);
 
-    extern "C" void ospray_init_module_cpp()
+    // NOTE(jda) - multi-ISA builds compile this module once per ISA, each with
+    //             its own init symbol (e.g. ospray_init_module_cpp_avx2)
+#ifndef OSPRAY_MODULE_CPP_INIT
+#  define OSPRAY_MODULE_CPP_INIT ospray_init_module_cpp
+#  define OSPRAY_MODULE_CPP_ISA_NAME "native"
+#endif
+
+    extern "C" void OSPRAY_MODULE_CPP_INIT()
     {
-      printf("Loaded plugin 'cpp' ...\n");
+      printf("Loaded plugin 'cpp' (%s, simd width %i) ...\n",
+             OSPRAY_MODULE_CPP_ISA_NAME, int(simd::width));
     }
 
   }// namespace cpp_renderer
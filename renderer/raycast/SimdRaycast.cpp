@@ -57,6 +57,19 @@ namespace ospray {
       return "ospray::cpp_renderer::RaycastRenderer";
     }
 
+    void SimdRaycastRenderer::commit()
+    {
+      ospray::cpp_renderer::SimdRenderer::commit();
+
+      materialTable.build(model, MaterialTable::Entry{},
+        [](const ospray::Material *m, MaterialTable::Entry &e) {
+          auto *mat = dynamic_cast<const SimdRaycastMaterial*>(m);
+          if (mat)
+            e.Kd = mat->Kd;
+        }
+      );
+    }
+
     void SimdRaycastRenderer::renderSample(simd::vmaski active,
                                            void */*perFrameData*/,
                                            ScreenSampleN &screenSample) const
@@ -69,18 +82,7 @@ namespace ospray {
         const auto c = 0.2f + 0.8f * simd::abs(dot(normalize(ray.Ng), ray.dir));
         auto dg = postIntersect(hit,ray,DG_MATERIALID|DG_COLOR|DG_TEXCOORD);
 
-        simd::vec3f col{c};
-
-        simd::foreach_active(hit, [&](int i) {
-          auto *mat = dynamic_cast<SimdRaycastMaterial*>(dg.material[i]);
-
-          auto eye_col = c[i];
-          if (mat) {
-            col.x[i] = eye_col * mat->Kd.x;
-            col.y[i] = eye_col * mat->Kd.y;
-            col.z[i] = eye_col * mat->Kd.z;
-          }
-        });
+        const auto col = c * materialTable.Kd(hit, dg.materialID);
 
         screenSample.rgb   = simd::select(hit, col, simd::vec3f{bgColor});
         screenSample.z     = simd::select(hit, ray.t, screenSample.z);
@@ -24,6 +24,7 @@ namespace ospray {
     struct SimdRaycastRenderer : public ospray::cpp_renderer::SimdRenderer
     {
       std::string toString() const override;
+      void commit() override;
 
       void renderSample(simd::vmaski active,
                         void *perFrameData,
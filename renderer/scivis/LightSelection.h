@@ -0,0 +1,56 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "../../lights/Light.h"
+#include "../../math/AliasTable.h"
+// std
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief build an alias table selecting lights proportional to their
+     *         power, for evaluating a fixed number of lights per hit
+
+        A light's power is taken from its Light_Bounds; unbounded lights
+        (whose radiance bound is infinite) get the largest finite power, so
+        they are still selected as often as the brightest bounded light. */
+    inline void buildLightSelection(
+        const std::vector<cpp_renderer::Light*> &lights,
+        ospcommon::AliasTable &table)
+    {
+      std::vector<float> power(lights.size());
+
+      float maxFinitePower = 0.f;
+
+      for (size_t i = 0; i < lights.size(); ++i) {
+        power[i] = lights[i]->bounds().maxRadiance;
+        if (power[i] < float(inf))
+          maxFinitePower = std::max(maxFinitePower, power[i]);
+      }
+
+      for (auto &p : power) {
+        if (p >= float(inf))
+          p = maxFinitePower > 0.f ? maxFinitePower : 1.f;
+      }
+
+      table.build(power);
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,145 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "LightTree.h"
+// std
+#include <algorithm>
+#include <numeric>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    static constexpr int MAX_LIGHTS_PER_LEAF = 2;
+
+    void LightTree::build(const std::vector<cpp_renderer::Light*> &lights,
+                          float threshold)
+    {
+      cullThreshold = threshold;
+
+      nodes.clear();
+      lightIndices.clear();
+      unbounded.clear();
+
+      std::vector<Light_Bounds> bounds;
+
+      for (size_t i = 0; i < lights.size(); ++i) {
+        const auto b = lights[i]->bounds();
+        if (b.bounded) {
+          lightIndices.push_back(i);
+          bounds.push_back(b);
+        } else {
+          unbounded.push_back(i);
+        }
+      }
+
+      if (lightIndices.empty())
+        return;
+
+      // NOTE(jda) - the two children of a node are allocated together
+      nodes.reserve(2 * lightIndices.size());
+      nodes.emplace_back();
+      buildNode(bounds, 0, 0, lightIndices.size());
+    }
+
+    void LightTree::buildNode(std::vector<Light_Bounds> &bounds,
+                              int nodeID,
+                              int begin,
+                              int end)
+    {
+      // Bounding cone //
+
+      vec3f axisSum {0.f};
+      float maxRadiance = 0.f;
+
+      for (int i = begin; i < end; ++i) {
+        axisSum    += bounds[i].axis;
+        maxRadiance = std::max(maxRadiance, bounds[i].maxRadiance);
+      }
+
+      const float axisLength = length(axisSum);
+      const vec3f axis = axisLength > 1e-6f ? axisSum / axisLength :
+                                              bounds[begin].axis;
+
+      float angle = 0.f;
+
+      for (int i = begin; i < end; ++i) {
+        const float cosToAxis = ospcommon::clamp(dot(axis, bounds[i].axis),
+                                                 -1.f, 1.f);
+        const float lightAngle = acosf(ospcommon::clamp(bounds[i].cosAngle,
+                                                        -1.f, 1.f));
+        angle = std::max(angle, acosf(cosToAxis) + lightAngle);
+      }
+
+      {
+        auto &node = nodes[nodeID];
+        node.axis        = axis;
+        node.cosAngle    = angle >= float(M_PI) ? -1.f : cosf(angle);
+        node.maxRadiance = maxRadiance;
+        node.first       = begin;
+        node.count       = end - begin;
+      }
+
+      if (end - begin <= MAX_LIGHTS_PER_LEAF)
+        return;
+
+      // Split at the median along the largest extent of the axes //
+
+      box3f axisBounds = empty;
+      for (int i = begin; i < end; ++i)
+        axisBounds.extend(bounds[i].axis);
+
+      const vec3f extent = axisBounds.size();
+      const int dim = extent.x >= extent.y ?
+                      (extent.x >= extent.z ? 0 : 2) :
+                      (extent.y >= extent.z ? 1 : 2);
+
+      std::vector<int> order(end - begin);
+      std::iota(order.begin(), order.end(), begin);
+
+      const int mid = (end - begin) / 2;
+      std::nth_element(order.begin(), order.begin() + mid, order.end(),
+                       [&](int a, int b) {
+                         return bounds[a].axis[dim] < bounds[b].axis[dim];
+                       });
+
+      std::vector<Light_Bounds> sortedBounds(end - begin);
+      std::vector<int>          sortedIndices(end - begin);
+
+      for (int i = 0; i < end - begin; ++i) {
+        sortedBounds[i]  = bounds[order[i]];
+        sortedIndices[i] = lightIndices[order[i]];
+      }
+
+      std::copy(sortedBounds.begin(), sortedBounds.end(),
+                bounds.begin() + begin);
+      std::copy(sortedIndices.begin(), sortedIndices.end(),
+                lightIndices.begin() + begin);
+
+      // Children //
+
+      const int childID = nodes.size();
+      nodes.emplace_back();
+      nodes.emplace_back();
+
+      nodes[nodeID].first = childID;
+      nodes[nodeID].count = 0;
+
+      buildNode(bounds, childID,     begin,       begin + mid);
+      buildNode(bounds, childID + 1, begin + mid, end);
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,144 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "../../lights/Light.h"
+// std
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief bounding volume hierarchy over the lights of a renderer
+
+        Built in commit() from each light's Light_Bounds: bounded lights are
+        organized in a binary tree of direction cones, each node storing the
+        cone enclosing the directions towards all of its lights and the
+        largest radiance among them. At a shading point a whole subtree is
+        skipped if the contribution it can at most make (its radiance times
+        a bound of the BRDF over the cone) is below 'cullThreshold', so
+        those lights are neither evaluated nor shadow-tested. Unbounded
+        lights are always visited. */
+    struct LightTree
+    {
+      void build(const std::vector<cpp_renderer::Light*> &lights,
+                 float cullThreshold);
+
+      /*! \brief call 'fcn(int lightIndex)' for every light which may
+       *         contribute more than the cull threshold at a point with
+       *         normal N and BRDF coefficients bounded by maxKd and maxKs
+
+          Lights are identified by their index in the vector given to
+          build(). With 'singleSided', lights below the horizon of N are
+          never visited. */
+      template <typename FCN>
+      void traverse(const vec3f &N,
+                    bool singleSided,
+                    float maxKd,
+                    float maxKs,
+                    FCN &&fcn) const;
+
+    private:
+
+      struct Node
+      {
+        vec3f axis;
+        float cosAngle;
+        float maxRadiance;
+        int   first;  //!< leaf: first light in 'lightIndices', else 1st child
+        int   count;  //!< number of lights in a leaf, 0 for inner nodes
+      };
+
+      void buildNode(std::vector<Light_Bounds> &bounds,
+                     int nodeID,
+                     int begin,
+                     int end);
+
+      //! \brief largest possible cos(N, L) over all L in a node's cone
+      static float maxCosine(const vec3f &N, const Node &node);
+
+      // Data //
+
+      float cullThreshold {0.f};
+
+      std::vector<Node> nodes;
+      std::vector<int>  lightIndices; //!< bounded lights, in leaf order
+      std::vector<int>  unbounded;
+    };
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline float LightTree::maxCosine(const vec3f &N, const Node &node)
+    {
+      const float cosTheta = dot(N, node.axis);
+
+      if (cosTheta >= node.cosAngle)
+        return 1.f;
+
+      // cos(theta - angle), theta being the angle between N and the axis
+      const float sinTheta = sqrtf(std::max(0.f, 1.f - cosTheta * cosTheta));
+      const float sinAngle =
+          sqrtf(std::max(0.f, 1.f - node.cosAngle * node.cosAngle));
+
+      return cosTheta * node.cosAngle + sinTheta * sinAngle;
+    }
+
+    template <typename FCN>
+    inline void LightTree::traverse(const vec3f &N,
+                                    bool singleSided,
+                                    float maxKd,
+                                    float maxKs,
+                                    FCN &&fcn) const
+    {
+      for (const auto i : unbounded)
+        fcn(i);
+
+      if (nodes.empty())
+        return;
+
+      int stack[64];
+      int stackSize = 0;
+      stack[stackSize++] = 0;
+
+      while (stackSize > 0) {
+        const auto &node = nodes[stack[--stackSize]];
+
+        float cosNL = maxCosine(N, node);
+
+        if (!singleSided)
+          cosNL = std::max(cosNL, maxCosine(-N, node));
+        else if (cosNL < 0.f)
+          continue;
+
+        const float maxContrib =
+            node.maxRadiance * (maxKd * std::max(cosNL, 0.f) + maxKs);
+
+        if (maxContrib < cullThreshold)
+          continue;
+
+        if (node.count > 0) {
+          for (int i = 0; i < node.count; ++i)
+            fcn(lightIndices[node.first + i]);
+        } else {
+          stack[stackSize++] = node.first;
+          stack[stackSize++] = node.first + 1;
+        }
+      }
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -20,6 +20,11 @@
 
 #include "common/Data.h"
 #include "cpp_renderer/lights/AmbientLight.h"
+#include "cpp_renderer/lights/DirectionalLight.h"
+
+#include <random>
+
+static thread_local std::minstd_rand generator;
 
 namespace ospray {
   namespace cpp_renderer {
@@ -44,6 +49,12 @@ namespace ospray {
       Ref<Texture2D> map_Kd;
       Ref<Texture2D> map_Ks;
       Ref<Texture2D> map_Ns;
+
+      //! \brief mip-mapped copies of the maps used for lookups
+      std::shared_ptr<const MipMapTexture> tex_d;
+      std::shared_ptr<const MipMapTexture> tex_Kd;
+      std::shared_ptr<const MipMapTexture> tex_Ks;
+      std::shared_ptr<const MipMapTexture> tex_Ns;
     };
 
     void SciVisMaterial::commit()
@@ -56,6 +67,11 @@ namespace ospray {
       map_Ns = (Texture2D*)getParamObject("map_Ns",
                                           getParamObject("map_ns", nullptr));
 
+      tex_d  = MipMapTexture::get(map_d.ptr);
+      tex_Kd = MipMapTexture::get(map_Kd.ptr);
+      tex_Ks = MipMapTexture::get(map_Ks.ptr);
+      tex_Ns = MipMapTexture::get(map_Ns.ptr);
+
       d  = getParam1f("d", 1.f);
       Kd = getParam3f("kd", getParam3f("Kd", vec3f(.8f)));
       Ks = getParam3f("ks", getParam3f("Ks", vec3f(0.f)));
@@ -98,13 +114,79 @@ namespace ospray {
       shadowsEnabled      = getParam1i("shadowsEnabled", 1);
       singleSidedLighting = getParam1i("oneSidedLighting", 1);
 
+      lightTree.build(lights, getParam1f("lightCullThreshold", .01f));
+
+      lightSamples = getParam1i("lightSamples", 0);
+      buildLightSelection(lights, lightSelection);
+
+      // NOTE(jda) - shadow maps replace shadow rays in the first
+      //             'shadowMapFrames' accumulated frames only
+      shadowMapFrames = getParam1i("shadowMapFrames", 1);
+      updateShadowMaps(shadowMaps, lights,
+                       getParam1i("shadowMaps", 0),
+                       model,
+                       getParam1i("shadowMapResolution", 2048),
+                       getParam1i("shadowMapMemory", 64));
+
       // ao parameters
       samplesPerFrame = getParam1i("aoSamples", 1);
       aoDistance      = getParam1f("aoDistance", 1e20f);
+      aoAdaptive      = getAOAdaptiveParams(*this);
+      halfResAO       = getHalfResAOParams(*this);
 
       // "aoWeight" is deprecated, use an ambient light instead
       if (!ambientLights)
         aoColor = vec3f(getParam1f("aoWeight", 0.f));
+
+      const float defaultCellSize =
+          model ? defaultAOCacheCellSize(model->bounds) : 1.f;
+
+      aoCache.update(getParam1i("aoCache", 0),
+                     model,
+                     aoDistance,
+                     getParam1i("aoCacheLog2Size", 22),
+                     getParam1f("aoCacheCellSize", defaultCellSize),
+                     getParam1i("aoCacheSamples", 256));
+
+      // NOTE(jda) - only used for the opacity of shadow casters (lightAlpha())
+      materialTable.build(model, MaterialTable::Entry{},
+        [](const ospray::Material *m, MaterialTable::Entry &e) {
+          auto *mat = dynamic_cast<const SciVisMaterial*>(m);
+          if (mat) {
+            e.Kd = mat->Kd;
+            e.Ks = mat->Ks;
+            e.Ns = mat->Ns;
+            e.d  = mat->d;
+          }
+        }
+      );
+
+      // per-vertex bake parameters
+      aoBake = getParam1i("aoBake", 0);
+      bakedLightSlot.assign(lights.size(), -1);
+
+      if (aoBake && model) {
+        VertexBakeSettings bake;
+        bake.aoSamples  = getParam1i("aoBakeSamples", 64);
+        bake.aoDistance = aoDistance;
+
+        // NOTE(jda) - only distant lights have a visibility that doesn't
+        //             depend on where on the mesh it is evaluated from
+        if (getParam1i("aoBakeShadows", 0)) {
+          DifferentialGeometry dg;
+          for (size_t i = 0; i < lights.size(); ++i) {
+            if (int(bake.lightDirections.size()) == DG_MAX_BAKED_LIGHTS)
+              break;
+            if (!dynamic_cast<cpp_renderer::DirectionalLight*>(lights[i]))
+              continue;
+            const auto light = lights[i]->sample(dg, vec2f{0.5f});
+            bakedLightSlot[i] = bake.lightDirections.size();
+            bake.lightDirections.push_back(light.dir);
+          }
+        }
+
+        bakeVertexLighting(model, bake);
+      }
     }
 
     inline SciVisShadingInfo
@@ -118,20 +200,16 @@ namespace ospray {
         // textures modify (mul) values, see
         //   http://paulbourke.net/dataformats/mtl/
         info.Kd = mat->Kd * vec3f{dg.color.x, dg.color.y, dg.color.z};
-#if 0// NOTE(jda) - texture fetches not yet implemented
-        info.d = mat->d * get1f(mat->map_d, dg.st, 1.f);
-        if (mat->map_Kd) {
-          vec4f Kd_from_map = get4f(mat->map_Kd, dg.st);
-          info.Kd = info.Kd * make_vec3f(Kd_from_map);
+        info.d = mat->d * get1f(mat->tex_d.get(), dg.st, dg.stWidth, 1.f);
+        if (mat->tex_Kd) {
+          vec4f Kd_from_map = mat->tex_Kd->sample(dg.st, dg.stWidth);
+          info.Kd = info.Kd *
+                    vec3f(Kd_from_map.x, Kd_from_map.y, Kd_from_map.z);
           info.d *= Kd_from_map.w;
         }
-        info.Ks = mat->Ks * get3f(mat->map_Ks, dg.st, make_vec3f(1.f));
-        info.Ns = mat->Ns * get1f(mat->map_Ns, dg.st, 1.f);
-#else
-        info.d  = mat->d;
-        info.Ks = mat->Ks;
-        info.Ns = mat->Ns;
-#endif
+        info.Ks = mat->Ks * get3f(mat->tex_Ks.get(), dg.st, dg.stWidth,
+                                  vec3f(1.f));
+        info.Ns = mat->Ns * get1f(mat->tex_Ns.get(), dg.st, dg.stWidth, 1.f);
       } else {
         info.Kd = vec3f{dg.color.x, dg.color.y, dg.color.z};
       }
@@ -143,28 +221,45 @@ namespace ospray {
       return info;
     }
 
-    inline vec3f SciVisRenderer::shade_ao(const DifferentialGeometry &dg,
-                                          const SciVisShadingInfo &info,
-                                          const Ray &ray) const
+    inline float SciVisRenderer::occlusion(const AOSurface &surface) const
     {
-      int hits = 0;
+      if (surface.bakedAO >= 0.f)
+        return surface.bakedAO;
+
+      const auto dg = getAOSurfaceDG(surface);
+
       auto aoContext = getAOContext(dg, aoDistance, epsilon);
 
-      for (int i = 0; i < samplesPerFrame; i++) {
-        auto ao_ray = calculateAORay(dg, aoContext);
-        if (dot(ao_ray.dir, dg.Ng) < 0.05f || isOccluded(ao_ray))
-          hits++;
-      }
+      auto traceSamples = [&](int numSamples) {
+        int hits = 0;
+        // NOTE(jda) - a single AO ray is cheaper to trace on its own
+        if (numSamples > 1) {
+          hits = traceAOPacketBundle(dg, aoContext, dg.Ng,
+                                     aoContext.rayLength - aoContext.epsilon,
+                                     numSamples,
+                                     [&](simd::vmaski active, RayN &rays) {
+                                       return isOccluded(active, rays);
+                                     });
+        } else {
+          for (int i = 0; i < numSamples; i++) {
+            auto ao_ray = calculateAORay(dg, aoContext);
+            if (dot(ao_ray.dir, dg.Ng) < 0.05f || isOccluded(ao_ray))
+              hits++;
+          }
+        }
+        return hits;
+      };
 
-      float diffuse = ospcommon::abs(dot(dg.Ng, ray.dir));
-      return info.Kd *
-             (diffuse * aoColor * (1.0f-float(hits)/samplesPerFrame));
+      return aoCache.enabled() ?
+          aoCache.occlusion(dg.P, dg.Ng, samplesPerFrame, traceSamples) :
+          adaptiveOcclusion(aoAdaptive, samplesPerFrame, traceSamples);
     }
 
     vec3f SciVisRenderer::shade_lights(const DifferentialGeometry &dg,
                                        const SciVisShadingInfo &info,
                                        const Ray &ray,
-                                       int path_depth) const
+                                       int path_depth,
+                                       bool useShadowMaps) const
     {
       const vec3f R = ray.dir - ((2.f * dot(ray.dir, dg.Ng)) * dg.Ng);
 
@@ -174,73 +269,138 @@ namespace ospray {
 
       vec3f color{0.f};
 
-      //calculate shading for all lights
-      for (const auto *l : lights) {
-        const auto light = l->sample(dg, vec2f{0.5f});
+      // NOTE(jda) - 'weight' is 1 / (expected number of times light 'i' is
+      //             evaluated) when lights are selected stochastically
+      auto shade_light = [&](int i, float weight, const vec2f &s) {
+        const auto light = lights[i]->sample(dg, s);
 
         if (reduce_max(light.weight) > 0.f) { // any potential contribution?
           float cosNL = dot(light.dir, dg.Ng);
 
           if (singleSidedLighting) {
             if (cosNL < 0.0f)
-              continue;
+              return;
           }
           else
             cosNL = fabs(cosNL);
 
           const float cosLR = ospcommon::max(0.f, dot(light.dir, R));
-          const vec3f brdf = info.Kd * cosNL + info.Ks * powf(cosLR, info.Ns);
-          const vec3f light_contrib = brdf * light.weight;
+          const vec3f brdf = info.Kd * cosNL +
+                             info.Ks * ospcommon::fast_pow(cosLR, info.Ns);
+          const vec3f light_contrib = brdf * light.weight * weight;
 
           if (shadowsEnabled) {
             const float max_contrib = reduce_max(light_contrib);
-            if (max_contrib > .01f) {
-              Ray shadowRay;
-              shadowRay.org = P;
-              shadowRay.dir = light.dir;
-              shadowRay.t0  = 0.f;
-              shadowRay.t   = inf;
-#if 0
-              const float light_alpha = lightAlpha(shadowRay,
-                                                   model,
-                                                   max_contrib,
-                                                   maxDepth - path_depth,
-                                                   epsilon);
-#else
-              float light_alpha = 1.0f;
-              if (isOccluded(shadowRay)) {
-                light_alpha = 0.f;
+            const int slot = bakedLightSlot[i];
+            if (slot >= 0 && slot < dg.numBakedLights) {
+              color += dg.bakedLightVisibility[slot] * light_contrib;
+            } else if (max_contrib > .01f) {
+              float light_alpha = 1.f;
+              if (useShadowMaps && shadowMaps[i].valid()) {
+                light_alpha = shadowMaps[i].visibility(dg.P, dg.Ng);
+              } else {
+                Ray shadowRay;
+                shadowRay.org = P;
+                shadowRay.dir = light.dir;
+                shadowRay.t0  = 0.f;
+                shadowRay.t   = inf;
+                light_alpha = lightAlpha(shadowRay, max_contrib);
               }
-#endif
               color += light_alpha * light_contrib;
             }
           } else {
             color += light_contrib;
           }
         }
+      };
+
+      if (lightSamples > 0 && !lightSelection.empty()) {
+        // constant cost: a fixed number of lights, chosen by power
+        static std::uniform_real_distribution<float> distribution {0.f, 1.f};
+
+        for (int k = 0; k < lightSamples; ++k) {
+          const int i = lightSelection.sample(distribution(generator));
+          const vec2f s {distribution(generator), distribution(generator)};
+          shade_light(i, 1.f / (lightSamples * lightSelection.pdf(i)), s);
+        }
+      } else {
+        //calculate shading for all lights which may contribute
+        lightTree.traverse(dg.Ng, singleSidedLighting,
+                           reduce_max(info.Kd), reduce_max(info.Ks),
+                           [&](int i) { shade_light(i, 1.f, vec2f{0.5f}); });
       }
 
       return color;
     }
 
-    void SciVisRenderer::renderSample(void *perFrameData,
-                                      ScreenSample &sample) const
+    inline void SciVisRenderer::shade_surface(ScreenSample &sample,
+                                              AOSurface &surface) const
     {
-      UNUSED(perFrameData);
       auto &ray = sample.ray;
 
-      if (traceRay(ray)) {
-        auto dg = postIntersect(ray, DG_NG|DG_NS|DG_NORMALIZE|DG_FACEFORWARD|
-                                     DG_MATERIALID|DG_COLOR|DG_TEXCOORD);
-        auto info = computeShadingInfo(dg);
+      auto dg = postIntersect(ray, DG_NG|DG_NS|DG_NORMALIZE|DG_FACEFORWARD|
+                                   DG_MATERIALID|DG_COLOR|DG_TEXCOORD|
+                                   (aoBake ? DG_BAKED : 0));
+      auto info = computeShadingInfo(dg);
 
-        sample.rgb = vec3f{0.f};
+      float diffuse = ospcommon::abs(dot(dg.Ng, ray.dir));
 
-        auto aoColor     = shade_ao(dg, info, sample.ray);
-        auto lightsColor = shade_lights(dg, info, sample.ray, 0);
+      surface.hit       = true;
+      surface.depth     = ray.t;
+      surface.P         = dg.P;
+      surface.Ng        = dg.Ng;
+      surface.Ns        = dg.Ns;
+      const bool interactive = sample.sampleID.z < shadowMapFrames * spp;
+
+      surface.baseColor = shade_lights(dg, info, ray, 0, interactive);
+      surface.aoWeight  = info.Kd * (diffuse * aoColor);
+      surface.bakedAO   = dg.bakedAO;
+
+      if (denoiser.enabled()) {
+        // NOTE(jda) - undo the BRDF normalization of Kd for the albedo guide
+        denoiser.setGuides(sample.sampleID.x, sample.sampleID.y,
+                           ray.t, dg.Ns, info.Kd * float(pi));
+      }
+    }
 
-        sample.rgb = aoColor + lightsColor;
+    void SciVisRenderer::renderTile(void *perFrameData,
+                                    Tile &tile,
+                                    size_t jobID) const
+    {
+      if (!halfResAO.enabled) {
+        Renderer::renderTile(perFrameData, tile, jobID);
+        return;
+      }
+
+      renderJobHalfResAO(
+        halfResAO, jobID, spp,
+        [&](size_t i, int s, ScreenSample &sample) {
+          return generateSample(tile, i, s, sample);
+        },
+        [&](ScreenSample &sample, AOSurface &surface) {
+          if (traceRay(sample.ray))
+            shade_surface(sample, surface);
+          else
+            sample.rgb = bgColor;
+        },
+        [&](const AOSurface &surface) {
+          return occlusion(surface);
+        },
+        [&](size_t i, ScreenSample &sample) {
+          writeSample(tile, i, sample);
+        }
+      );
+    }
+
+    void SciVisRenderer::renderSample(void *perFrameData,
+                                      ScreenSample &sample) const
+    {
+      UNUSED(perFrameData);
 
+      if (traceRay(sample.ray)) {
+        AOSurface surface;
+        shade_surface(sample, surface);
+        sample.rgb = resolveAO(surface, occlusion(surface));
       } else {
         sample.rgb = bgColor;
       }
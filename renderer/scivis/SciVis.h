@@ -18,6 +18,13 @@
 
 #include "../Renderer.h"
 #include "../../lights/Light.h"
+#include "../simple_ao/AOCache.h"
+#include "../simple_ao/HalfResAO.h"
+#include "../simple_ao/VertexBaker.h"
+#include "../simple_ao/ao_util.h"
+#include "LightSelection.h"
+#include "LightTree.h"
+#include "ShadowMap.h"
 #include "SciVisShadingInfo.h"
 
 namespace ospray {
@@ -28,6 +35,10 @@ namespace ospray {
       std::string toString() const override;
       void commit() override;
 
+      void renderTile(void *perFrameData,
+                      Tile &tile,
+                      size_t jobID) const override;
+
       void renderSample(void *perFrameData,
                         ScreenSample &sample) const override;
 
@@ -39,14 +50,16 @@ namespace ospray {
       SciVisShadingInfo
       computeShadingInfo(const DifferentialGeometry &dg) const;
 
-      vec3f shade_ao(const DifferentialGeometry &dg,
-                     const SciVisShadingInfo &info,
-                     const Ray &ray) const;
+      //! \brief shade a hit, except for AO
+      void shade_surface(ScreenSample &sample, AOSurface &surface) const;
+
+      float occlusion(const AOSurface &surface) const;
 
       vec3f shade_lights(const DifferentialGeometry &dg,
                          const SciVisShadingInfo &info,
                          const Ray &ray,
-                         int path_depth) const;
+                         int path_depth,
+                         bool useShadowMaps) const;
 
       // Data //
 
@@ -56,8 +69,25 @@ namespace ospray {
       float aoDistance {1e20f};
       vec3f aoColor {0.f};
       int   maxDepth {10};
+      bool  aoBake {false};
+
+      ao_adaptive     aoAdaptive;
+      HalfResAOParams halfResAO;
+      AOCache         aoCache;
 
       std::vector<cpp_renderer::Light*> lights;
+      LightTree lightTree;
+
+      //! lights evaluated per hit when > 0, selected with 'lightSelection'
+      int lightSamples {0};
+      ospcommon::AliasTable lightSelection;
+
+      //! per light, only valid for directional lights with 'shadowMaps' set
+      std::vector<ShadowMap> shadowMaps;
+      int shadowMapFrames {1};
+
+      //! slot of each light in the per-vertex bake, -1 if not baked
+      std::vector<int> bakedLightSlot;
     };
 
   }// namespace cpp_renderer
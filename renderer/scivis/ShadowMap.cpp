@@ -0,0 +1,227 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "ShadowMap.h"
+#include "../../common/Ray.h"
+#include "../../geometry/TriangleMesh.h"
+#include "../../lights/DirectionalLight.h"
+// ospray
+#include "ospcommon/tasking/parallel_for.h"
+// embree
+#include "embree2/rtcore.h"
+#include "embree2/rtcore_scene.h"
+// std
+#include <algorithm>
+#include <cmath>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // Helper functions ///////////////////////////////////////////////////////
+
+    static inline void intersectStream(RTCScene scene, RayStream &rays)
+    {
+#if USE_EMBREE_STREAMS
+      RTCIntersectContext ctx{RTC_INTERSECT_COHERENT, nullptr};
+      rtcIntersect1M(scene, &ctx, (RTCRay*)&rays, rays.size(), sizeof(Ray));
+#else
+      for (int i = 0; i < STREAM_SIZE; ++i) {
+        auto &ray = rays[i];
+        if (rayIsActive(ray))
+          rtcIntersect(scene, reinterpret_cast<RTCRay&>(ray));
+      }
+#endif
+    }
+
+    // ShadowMap definitions //////////////////////////////////////////////////
+
+    void ShadowMap::update(bool enable,
+                           const Model *model,
+                           const vec3f &dirToLight,
+                           int resolution)
+    {
+      if (!enable || model == nullptr || model->embreeSceneHandle == nullptr) {
+        settings = Settings{};
+        depth.clear();
+        return;
+      }
+
+      // NOTE(jda) - a model commit finalizes (so re-stamps) its triangle
+      //             meshes and rebuilds its embree scene
+      auto geometries = geometryVersions(model);
+
+      const bool unchanged =
+          model                    == settings.model        &&
+          model->embreeSceneHandle == settings.scene        &&
+          geometries               == settings.geometries   &&
+          model->bounds.lower      == settings.bounds.lower &&
+          model->bounds.upper      == settings.bounds.upper &&
+          dirToLight               == settings.dir          &&
+          resolution               == settings.resolution;
+
+      if (unchanged && valid())
+        return;
+
+      settings.model      = model;
+      settings.scene      = model->embreeSceneHandle;
+      settings.geometries = std::move(geometries);
+      settings.bounds     = model->bounds;
+      settings.dir        = dirToLight;
+      settings.resolution = resolution;
+
+      build(model);
+    }
+
+    ShadowMap::GeometryVersions
+    ShadowMap::geometryVersions(const Model *model)
+    {
+      GeometryVersions result;
+      result.reserve(model->geometry.size());
+
+      for (const auto &g : model->geometry) {
+        const auto *mesh = dynamic_cast<const TriangleMesh*>(g.ptr);
+        result.emplace_back(g.ptr, mesh ? mesh->version : 0);
+      }
+
+      return result;
+    }
+
+    void ShadowMap::build(const Model *model)
+    {
+      frame = ospcommon::frame(settings.dir);
+      size  = ospcommon::clamp(settings.resolution, 16, 16384);
+
+      // bounds of the model in the light's frame
+      const auto &b = model->bounds;
+
+      vec3f localLower {float(inf)};
+      vec3f localUpper {float(neg_inf)};
+
+      for (int k = 0; k < 8; ++k) {
+        const vec3f corner((k & 1) ? b.upper.x : b.lower.x,
+                           (k & 2) ? b.upper.y : b.lower.y,
+                           (k & 4) ? b.upper.z : b.lower.z);
+        const vec3f local(dot(corner, frame.vx),
+                          dot(corner, frame.vy),
+                          dot(corner, frame.vz));
+        localLower = min(localLower, local);
+        localUpper = max(localUpper, local);
+      }
+
+      const vec3f extent = localUpper - localLower;
+      const float margin = 1e-3f * reduce_max(extent) + 1e-6f;
+
+      // NOTE(jda) - square texels, the map covers the larger extent
+      texelSize = (std::max(extent.x, extent.y) + 2.f * margin) / size;
+      lower     = vec2f(localLower.x - margin, localLower.y - margin);
+      plane     = localUpper.z + margin;
+
+      const float maxDepth = extent.z + 2.f * margin;
+
+      depth.assign(size_t(size) * size, inf);
+
+      const size_t numTexels = depth.size();
+      const int    numChunks = (numTexels + STREAM_SIZE - 1) / STREAM_SIZE;
+
+      tasking::parallel_for(numChunks, [&](int chunk) {
+        const size_t first = size_t(chunk) * STREAM_SIZE;
+        const int    n     = std::min<size_t>(STREAM_SIZE, numTexels - first);
+
+        RayStream rays;
+
+        for (int i = 0; i < n; ++i) {
+          const size_t t = first + i;
+          const float  x = lower.x + ((t % size) + .5f) * texelSize;
+          const float  y = lower.y + ((t / size) + .5f) * texelSize;
+
+          auto &ray = rays[i];
+          ray.org = x * frame.vx + y * frame.vy + plane * frame.vz;
+          ray.dir = -frame.vz;
+          ray.t0  = 0.f;
+          ray.t   = maxDepth;
+        }
+
+        intersectStream(model->embreeSceneHandle, rays);
+
+        for (int i = 0; i < n; ++i) {
+          if (rays[i].hitSomething())
+            depth[first + i] = rays[i].t;
+        }
+      });
+    }
+
+    float ShadowMap::visibility(const vec3f &P, const vec3f &N) const
+    {
+      // NOTE(jda) - offset along the normal and in depth by a texel, the
+      //             surface containing P is in the map itself
+      const vec3f Po = P + texelSize * N;
+
+      const float d  = plane - dot(Po, frame.vz) - texelSize;
+      const float gx = (dot(Po, frame.vx) - lower.x) / texelSize - .5f;
+      const float gy = (dot(Po, frame.vy) - lower.y) / texelSize - .5f;
+
+      const float fx = floorf(gx);
+      const float fy = floorf(gy);
+      const int   x  = int(fx);
+      const int   y  = int(fy);
+      const float tx = gx - fx;
+      const float ty = gy - fy;
+
+      const float lit00 = d <= texel(x,     y    ) ? 1.f : 0.f;
+      const float lit10 = d <= texel(x + 1, y    ) ? 1.f : 0.f;
+      const float lit01 = d <= texel(x,     y + 1) ? 1.f : 0.f;
+      const float lit11 = d <= texel(x + 1, y + 1) ? 1.f : 0.f;
+
+      return (1.f - ty) * ((1.f - tx) * lit00 + tx * lit10) +
+                    ty  * ((1.f - tx) * lit01 + tx * lit11);
+    }
+
+    // Helper definitions /////////////////////////////////////////////////////
+
+    void updateShadowMaps(std::vector<ShadowMap> &maps,
+                          const std::vector<cpp_renderer::Light*> &lights,
+                          bool enable,
+                          const Model *model,
+                          int resolution,
+                          int budgetMB)
+    {
+      maps.resize(lights.size());
+
+      auto isDirectional = [&](size_t i) {
+        return dynamic_cast<const DirectionalLight*>(lights[i]) != nullptr;
+      };
+
+      size_t numDirectional = 0;
+      for (size_t i = 0; i < lights.size(); ++i)
+        numDirectional += isDirectional(i);
+
+      // NOTE(jda) - shrink all maps alike rather than dropping some lights'
+      if (numDirectional > 0) {
+        const double budgetTexels =
+            double(std::max(budgetMB, 1)) * (1 << 20) / sizeof(float);
+        const int maxResolution =
+            int(std::sqrt(budgetTexels / numDirectional));
+        resolution = std::min(resolution, maxResolution);
+      }
+
+      for (size_t i = 0; i < lights.size(); ++i) {
+        maps[i].update(enable && isDirectional(i), model,
+                       lights[i]->bounds().axis, resolution);
+      }
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
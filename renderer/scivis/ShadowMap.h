@@ -0,0 +1,121 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "common/Model.h"
+// ospray_cpp
+#include "../../lights/Light.h"
+// std
+#include <utility>
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief depth map of the scene as seen from a distant light
+
+        The map is rendered once with an orthographic camera looking along
+        the light's direction, tracing the texels as ray streams, and covers
+        the whole model. Lookups compare a point's depth against the 2x2
+        nearest texels and filter the results bilinearly (percentage closer
+        filtering), so shadows are hard and occluders are opaque: it is an
+        approximation meant for interaction, not for converged frames.
+
+        Each map holds resolution^2 floats, so the maps of all lights share
+        one memory budget (see updateShadowMaps()). */
+    struct ShadowMap
+    {
+      /*! \brief rebuild the map if the model was recommitted, a triangle
+       *         mesh in it was (re)committed, or the direction towards the
+       *         light or the resolution changed, release it if 'enable' is
+       *         false */
+      void update(bool enable,
+                  const Model *model,
+                  const vec3f &dirToLight,
+                  int resolution);
+
+      bool valid() const;
+
+      /*! \brief fraction of light reaching P (on a surface with normal N) */
+      float visibility(const vec3f &P, const vec3f &N) const;
+
+    private:
+
+      void build(const Model *model);
+
+      float texel(int x, int y) const;
+
+      //! each geometry of the model with its TriangleMesh::version (0 for
+      //! other geometries)
+      using GeometryVersions = std::vector<std::pair<const void*, uint64_t>>;
+
+      static GeometryVersions geometryVersions(const Model *model);
+
+      struct Settings
+      {
+        const Model *model {nullptr};
+        RTCScene     scene {nullptr};
+        GeometryVersions geometries;
+        box3f  bounds;
+        vec3f  dir {0.f};
+        int    resolution {0};
+      };
+
+      // Data //
+
+      Settings settings;
+
+      linear3f frame;      //!< vz == direction towards the light
+      vec2f    lower;      //!< lower corner of the map in (vx, vy)
+      float    plane {0.f};//!< position of the map plane along vz
+      float    texelSize {0.f};
+      int      size {0};
+
+      //! distance from the map plane to the nearest occluder, inf if none
+      std::vector<float> depth;
+    };
+
+    /*! \brief keep one ShadowMap per light, valid ones for directional
+     *         lights if 'enable'
+
+        Maps are at most 'resolution' texels wide, less when the maps of all
+        directional lights wouldn't fit into 'budgetMB' megabytes. */
+    void updateShadowMaps(std::vector<ShadowMap> &maps,
+                          const std::vector<cpp_renderer::Light*> &lights,
+                          bool enable,
+                          const Model *model,
+                          int resolution,
+                          int budgetMB);
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline bool ShadowMap::valid() const
+    {
+      return !depth.empty();
+    }
+
+    inline float ShadowMap::texel(int x, int y) const
+    {
+      if (x < 0 || y < 0 || x >= size || y >= size)
+        return inf;
+
+      return depth[size_t(y) * size + x];
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
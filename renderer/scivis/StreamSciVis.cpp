@@ -21,6 +21,10 @@
 #include "common/Data.h"
 #include "cpp_renderer/lights/AmbientLight.h"
 
+#include <random>
+
+static thread_local std::minstd_rand generator;
+
 namespace ospray {
   namespace cpp_renderer {
 
@@ -44,6 +48,12 @@ namespace ospray {
       Ref<Texture2D> map_Kd;
       Ref<Texture2D> map_Ks;
       Ref<Texture2D> map_Ns;
+
+      //! \brief mip-mapped copies of the maps used for lookups
+      std::shared_ptr<const MipMapTexture> tex_d;
+      std::shared_ptr<const MipMapTexture> tex_Kd;
+      std::shared_ptr<const MipMapTexture> tex_Ks;
+      std::shared_ptr<const MipMapTexture> tex_Ns;
     };
 
     void StreamSciVisMaterial::commit()
@@ -56,6 +66,11 @@ namespace ospray {
       map_Ns = (Texture2D*)getParamObject("map_Ns",
                                           getParamObject("map_ns", nullptr));
 
+      tex_d  = MipMapTexture::get(map_d.ptr);
+      tex_Kd = MipMapTexture::get(map_Kd.ptr);
+      tex_Ks = MipMapTexture::get(map_Ks.ptr);
+      tex_Ns = MipMapTexture::get(map_Ns.ptr);
+
       d  = getParam1f("d", 1.f);
       Kd = getParam3f("kd", getParam3f("Kd", vec3f(.8f)));
       Ks = getParam3f("ks", getParam3f("Ks", vec3f(0.f)));
@@ -98,6 +113,20 @@ namespace ospray {
       shadowsEnabled      = getParam1i("shadowsEnabled", 1);
       singleSidedLighting = getParam1i("oneSidedLighting", 1);
 
+      lightTree.build(lights, getParam1f("lightCullThreshold", .01f));
+
+      lightSamples = getParam1i("lightSamples", 0);
+      buildLightSelection(lights, lightSelection);
+
+      // NOTE(jda) - shadow maps replace shadow rays in the first
+      //             'shadowMapFrames' accumulated frames only
+      shadowMapFrames = getParam1i("shadowMapFrames", 1);
+      updateShadowMaps(shadowMaps, lights,
+                       getParam1i("shadowMaps", 0),
+                       model,
+                       getParam1i("shadowMapResolution", 2048),
+                       getParam1i("shadowMapMemory", 64));
+
       // ao parameters
       samplesPerFrame = getParam1i("aoSamples", 1);
       aoDistance      = getParam1f("aoDistance", 1e20f);
@@ -105,6 +134,22 @@ namespace ospray {
       // "aoWeight" is deprecated, use an ambient light instead
       if (!ambientLights)
         aoColor = vec3f(getParam1f("aoWeight", 0.f));
+
+      materialTable.build(model, MaterialTable::Entry{},
+        [](const ospray::Material *m, MaterialTable::Entry &e) {
+          auto *mat = dynamic_cast<const StreamSciVisMaterial*>(m);
+          if (mat) {
+            e.Kd = mat->Kd;
+            e.Ks = mat->Ks;
+            e.Ns = mat->Ns;
+            e.d  = mat->d;
+            e.map_Kd = mat->tex_Kd;
+            e.map_Ks = mat->tex_Ks;
+            e.map_Ns = mat->tex_Ns;
+            e.map_d  = mat->tex_d;
+          }
+        }
+      );
     }
 
     void StreamSciVisRenderer::renderStream(void *perFrameData,
@@ -166,30 +211,29 @@ namespace ospray {
         [&](ScreenSampleRef sample, int i) {
           auto &info = ss[i];
           auto &dg   = dgs[i];
-
-          auto *mat = dynamic_cast<StreamSciVisMaterial*>(dg.material);
-
-          if (mat) {
-            // textures modify (mul) values, see
-            //   http://paulbourke.net/dataformats/mtl/
-            info.Kd = mat->Kd * vec3f{dg.color.x, dg.color.y, dg.color.z};
-#if 0// NOTE(jda) - texture fetches not yet implemented
-            info.d = mat->d * get1f(mat->map_d, dg.st, 1.f);
-            if (mat->map_Kd) {
-              vec4f Kd_from_map = get4f(mat->map_Kd, dg.st);
-              info.Kd = info.Kd * make_vec3f(Kd_from_map);
-              info.d *= Kd_from_map.w;
-            }
-            info.Ks = mat->Ks * get3f(mat->map_Ks, dg.st, make_vec3f(1.f));
-            info.Ns = mat->Ns * get1f(mat->map_Ns, dg.st, 1.f);
-#else
-            info.d  = mat->d;
-            info.Ks = mat->Ks;
-            info.Ns = mat->Ns;
-#endif
-          } else {
-            info.Kd = vec3f{dg.color.x, dg.color.y, dg.color.z};
+          auto &ray  = stream.rays[i];
+
+          // NOTE(jda) - instances aren't in the table, use the fallback
+          const int id = ray.instID < 0 ?
+                         materialTable.lookup(ray.geomID, ray.primID) : 0;
+          const auto mat = materialTable.get(id);
+
+          // textures modify (mul) values, see
+          //   http://paulbourke.net/dataformats/mtl/
+          info.Kd = mat.Kd * vec3f{dg.color.x, dg.color.y, dg.color.z};
+          const auto *map_Kd = materialTable.map_Kd(id);
+          info.d = mat.d * get1f(materialTable.map_d(id), dg.st, dg.stWidth,
+                                 1.f);
+          if (map_Kd) {
+            vec4f Kd_from_map = map_Kd->sample(dg.st, dg.stWidth);
+            info.Kd = info.Kd *
+                      vec3f(Kd_from_map.x, Kd_from_map.y, Kd_from_map.z);
+            info.d *= Kd_from_map.w;
           }
+          info.Ks = mat.Ks * get3f(materialTable.map_Ks(id), dg.st,
+                                   dg.stWidth, vec3f(1.f));
+          info.Ns = mat.Ns * get1f(materialTable.map_Ns(id), dg.st,
+                                   dg.stWidth, 1.f);
 
           // BRDF normalization
           info.Kd *= static_cast<float>(one_over_pi);
@@ -266,6 +310,8 @@ namespace ospray {
     {
       RGBStream colors;
 
+      static std::uniform_real_distribution<float> distribution {0.f, 1.f};
+
       for_each_sample_i(
         stream,
         [&](ScreenSampleRef sample, int i) {
@@ -283,51 +329,63 @@ namespace ospray {
 
           auto &color = colors[i] = vec3f{0.f};
 
-          //calculate shading for all lights
-          for (const auto *l : lights) {
-            const auto light = l->sample(dg, vec2f{0.5f});
+          const bool useShadowMaps =
+              stream.sampleID[i].z < shadowMapFrames * spp;
+
+          // NOTE(jda) - 'weight' is 1 / (expected number of times light 'l'
+          //             is evaluated) when lights are selected stochastically
+          auto shade_light = [&](int l, float weight, const vec2f &s) {
+            const auto light = lights[l]->sample(dg, s);
 
             if (reduce_max(light.weight) > 0.f) { // any potential contribution?
               float cosNL = dot(light.dir, dg.Ng);
 
               if (singleSidedLighting) {
                 if (cosNL < 0.0f)
-                  continue;
+                  return;
               }
               else
                 cosNL = fabs(cosNL);
 
               const float cosLR = ospcommon::max(0.f, dot(light.dir, R));
               const vec3f brdf = info.Kd * cosNL +
-                                 info.Ks * powf(cosLR, info.Ns);
-              const vec3f light_contrib = brdf * light.weight;
+                                 info.Ks * ospcommon::fast_pow(cosLR, info.Ns);
+              const vec3f light_contrib = brdf * light.weight * weight;
 
               if (shadowsEnabled) {
                 const float max_contrib = reduce_max(light_contrib);
                 if (max_contrib > .01f) {
-                  Ray shadowRay;
-                  shadowRay.org = P;
-                  shadowRay.dir = light.dir;
-                  shadowRay.t0  = 0.f;
-                  shadowRay.t   = inf;
-#if 0
-                  const float light_alpha = lightAlpha(shadowRay,
-                                                       model,
-                                                       max_contrib,
-                                                       maxDepth - path_depth,
-                                                       epsilon);
-#else
-                  float light_alpha = 1.0f;
-                  if (isOccluded(shadowRay)) {
-                    light_alpha = 0.f;
+                  float light_alpha = 1.f;
+                  if (useShadowMaps && shadowMaps[l].valid()) {
+                    light_alpha = shadowMaps[l].visibility(dg.P, dg.Ng);
+                  } else {
+                    Ray shadowRay;
+                    shadowRay.org = P;
+                    shadowRay.dir = light.dir;
+                    shadowRay.t0  = 0.f;
+                    shadowRay.t   = inf;
+                    light_alpha = lightAlpha(shadowRay, max_contrib);
                   }
-#endif
                   color += light_alpha * light_contrib;
                 }
               } else {
                 color += light_contrib;
               }
             }
+          };
+
+          if (lightSamples > 0 && !lightSelection.empty()) {
+            // constant cost: a fixed number of lights, chosen by power
+            for (int k = 0; k < lightSamples; ++k) {
+              const int l = lightSelection.sample(distribution(generator));
+              const vec2f s {distribution(generator), distribution(generator)};
+              shade_light(l, 1.f / (lightSamples * lightSelection.pdf(l)), s);
+            }
+          } else {
+            //calculate shading for all lights which may contribute
+            lightTree.traverse(dg.Ng, singleSidedLighting,
+                               reduce_max(info.Kd), reduce_max(info.Ks),
+                               [&](int l) { shade_light(l, 1.f, vec2f{.5f}); });
           }
         },
         rayHit
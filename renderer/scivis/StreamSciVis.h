@@ -18,6 +18,9 @@
 
 #include "../StreamRenderer.h"
 #include "../../lights/Light.h"
+#include "LightSelection.h"
+#include "LightTree.h"
+#include "ShadowMap.h"
 #include "SciVisShadingInfo.h"
 
 namespace ospray {
@@ -62,6 +65,15 @@ namespace ospray {
       int   maxDepth {10};
 
       std::vector<cpp_renderer::Light*> lights;
+      LightTree lightTree;
+
+      //! lights evaluated per hit when > 0, selected with 'lightSelection'
+      int lightSamples {0};
+      ospcommon::AliasTable lightSelection;
+
+      //! per light, only valid for directional lights with 'shadowMaps' set
+      std::vector<ShadowMap> shadowMaps;
+      int shadowMapFrames {1};
     };
 
   }// namespace cpp_renderer
@@ -0,0 +1,141 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "AOCache.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // Helper functions ///////////////////////////////////////////////////////
+
+    static inline uint64_t mix64(uint64_t k)
+    {
+      // splitmix64 finalizer
+      k ^= k >> 30;
+      k *= 0xbf58476d1ce4e5b9ull;
+      k ^= k >> 27;
+      k *= 0x94d049bb133111ebull;
+      k ^= k >> 31;
+      return k;
+    }
+
+    static inline uint64_t quantizeNormal(float n)
+    {
+      const int q = static_cast<int>((n * 0.5f + 0.5f) * 4.f);
+      return static_cast<uint64_t>(ospcommon::clamp(q, 0, 3));
+    }
+
+    // AOCache definitions ////////////////////////////////////////////////////
+
+    void AOCache::update(bool enable,
+                         const void *scene,
+                         float aoDistance,
+                         int log2Cells,
+                         float cellSize,
+                         int samples)
+    {
+      const bool unchanged = enable     == settings.enable     &&
+                             scene      == settings.scene      &&
+                             aoDistance == settings.aoDistance &&
+                             log2Cells  == settings.log2Cells  &&
+                             cellSize   == settings.cellSize   &&
+                             samples    == settings.targetSamples;
+
+      if (unchanged)
+        return;
+
+      settings.enable        = enable;
+      settings.scene         = scene;
+      settings.aoDistance    = aoDistance;
+      settings.log2Cells     = log2Cells;
+      settings.cellSize      = cellSize;
+      settings.targetSamples = samples;
+
+      if (enable)
+        reset(log2Cells, cellSize, samples);
+      else
+        clear();
+    }
+
+    void AOCache::reset(int log2Cells, float cellSize, int samples)
+    {
+      const uint64_t numCells = uint64_t(1) << log2Cells;
+
+      cells.reset(new Cell[numCells]);
+      mask          = numCells - 1;
+      rcpCellSize   = 1.f / cellSize;
+      targetSamples = static_cast<uint32_t>(std::max(samples, 1));
+    }
+
+    void AOCache::clear()
+    {
+      cells.reset();
+      mask = 0;
+    }
+
+    uint64_t AOCache::computeKey(const vec3f &P, const vec3f &N) const
+    {
+      // 19 bits per position axis, 2 bits per normal component; the top bit
+      // is always set, so a key of 0 marks an empty cell
+      const uint64_t axisMask = (uint64_t(1) << 19) - 1;
+
+      auto quantize = [&](float v) {
+        return uint64_t(int64_t(floorf(v * rcpCellSize))) & axisMask;
+      };
+
+      const uint64_t x = quantize(P.x);
+      const uint64_t y = quantize(P.y);
+      const uint64_t z = quantize(P.z);
+
+      const uint64_t n = quantizeNormal(N.x)
+                         | (quantizeNormal(N.y) << 2)
+                         | (quantizeNormal(N.z) << 4);
+
+      return x | (y << 19) | (z << 38) | (n << 57) | (uint64_t(1) << 63);
+    }
+
+    AOCache::Cell *AOCache::findCell(uint64_t key) const
+    {
+      // NOTE(jda) - bounded linear probing: if the neighborhood is full the
+      //             caller simply doesn't cache the sample
+      static const int maxProbes = 16;
+
+      const uint64_t h = mix64(key);
+
+      for (int i = 0; i < maxProbes; ++i) {
+        Cell &cell = cells[(h + i) & mask];
+
+        uint64_t current = cell.key.load(std::memory_order_acquire);
+
+        if (current == key)
+          return &cell;
+
+        if (current == 0) {
+          if (cell.key.compare_exchange_strong(current, key,
+                                               std::memory_order_acq_rel))
+            return &cell;
+
+          // lost the race, check if the winner claimed it for the same key
+          if (current == key)
+            return &cell;
+        }
+      }
+
+      return nullptr;
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,146 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "common/OSPCommon.h"
+// std
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief world-space AO cache for static scenes
+
+        A spatial hash grid keyed by quantized hit position and normal. Each
+        cell accumulates AO hits and samples from all rendering threads
+        (lock-free: cells are claimed with a CAS on their key, and hits and
+        samples are packed in one 64-bit counter updated with fetch_add).
+        Cells keep receiving fresh samples until 'targetSamples' is reached,
+        after which lookups return the cached estimate without tracing.
+
+        The cache assumes the scene doesn't change; renderers reset it in
+        commit() when the model or AO parameters change. */
+    struct AOCache
+    {
+      /*! \brief called from a renderer's commit(), resets the cache if any
+       *         of the arguments changed since the last call ('scene'
+       *         identifies the model) */
+      void update(bool enable,
+                  const void *scene,
+                  float aoDistance,
+                  int log2Cells,
+                  float cellSize,
+                  int targetSamples);
+
+      /*! \brief (re)allocate with 2^log2Cells cells, clears all cells */
+      void reset(int log2Cells, float cellSize, int targetSamples);
+
+      void clear();
+
+      bool enabled() const;
+
+      /*! \brief fraction of occluded AO samples at (P, N)
+
+          'traceFcn(int n)' must trace n fresh AO samples at the hit point
+          and return the number of hits; it is only called while the
+          corresponding cell hasn't converged (or if no cell could be
+          allocated, in which case the result isn't cached). */
+      template <typename TRACE_FCN>
+      float occlusion(const vec3f &P,
+                      const vec3f &N,
+                      int numSamples,
+                      TRACE_FCN &&traceFcn) const;
+
+    private:
+
+      struct Cell
+      {
+        std::atomic<uint64_t> key {0};
+        std::atomic<uint64_t> counts {0}; //!< hits << 32 | samples
+      };
+
+      uint64_t computeKey(const vec3f &P, const vec3f &N) const;
+
+      //! find (or claim) the cell for 'key', nullptr if the probe fails
+      Cell *findCell(uint64_t key) const;
+
+      struct Settings
+      {
+        bool        enable {false};
+        const void *scene {nullptr};
+        float       aoDistance {0.f};
+        int         log2Cells {0};
+        float       cellSize {0.f};
+        int         targetSamples {0};
+      };
+
+      // Data //
+
+      Settings settings;
+
+      std::unique_ptr<Cell[]> cells;
+      uint64_t mask {0};
+      float    rcpCellSize {1.f};
+      uint32_t targetSamples {64};
+    };
+
+    // Inlined helper functions ///////////////////////////////////////////////
+
+    /*! \brief default cell edge length: 1/1024th of the scene diagonal */
+    inline float defaultAOCacheCellSize(const box3f &sceneBounds)
+    {
+      const float diagonal = length(sceneBounds.size());
+      return diagonal > 0.f ? diagonal / 1024.f : 1.f;
+    }
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline bool AOCache::enabled() const
+    {
+      return cells != nullptr;
+    }
+
+    template <typename TRACE_FCN>
+    inline float AOCache::occlusion(const vec3f &P,
+                                    const vec3f &N,
+                                    int numSamples,
+                                    TRACE_FCN &&traceFcn) const
+    {
+      if (numSamples <= 0)
+        return 0.f;
+
+      Cell *cell = findCell(computeKey(P, N));
+
+      if (cell == nullptr)
+        return float(traceFcn(numSamples)) / numSamples;
+
+      uint64_t counts = cell->counts.load(std::memory_order_relaxed);
+
+      if (uint32_t(counts) < targetSamples) {
+        const uint64_t hits = traceFcn(numSamples);
+        const uint64_t add  = (hits << 32) | uint64_t(numSamples);
+        counts = cell->counts.fetch_add(add, std::memory_order_relaxed) + add;
+      }
+
+      return float(counts >> 32) / float(uint32_t(counts));
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,222 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "../Renderer.h"
+#include "../../math/fast_math.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief a primary hit whose ambient occlusion is evaluated later
+
+        The final color of the sample is
+        'baseColor + aoWeight * (1 - occlusion)'. */
+    struct AOSurface
+    {
+      bool  hit {false};
+      float depth {inf}; //!< primary ray t
+      vec3f P;
+      vec3f Ng;
+      vec3f Ns;
+      vec3f baseColor {0.f}; //!< everything but the AO term
+      vec3f aoWeight  {0.f};
+      float bakedAO   {-1.f}; //!< per-vertex baked occlusion, < 0 if none
+    };
+
+    /*! \brief settings for evaluating AO on a subsampled grid
+
+        With 'enabled', AO is only traced for one primary hit per 2x2 pixel
+        quad; every pixel then gets a joint bilateral weighted average of
+        the nearby quads' occlusion, where weights fall off with the
+        relative depth difference ('depthSigma') and with the angle between
+        the normals (cosine raised to 'normalPower'). */
+    struct HalfResAOParams
+    {
+      bool  enabled {false};
+      float depthSigma {0.05f};
+      float normalPower {8.f};
+    };
+
+    // Inlined helper functions ///////////////////////////////////////////////
+
+    /*! \brief read the 'aoHalfRes*' parameters of a renderer */
+    inline HalfResAOParams getHalfResAOParams(ManagedObject &renderer)
+    {
+      HalfResAOParams params;
+      params.enabled     = renderer.getParam1i("aoHalfRes", 0);
+      params.depthSigma  = renderer.getParam1f("aoHalfResDepthSigma", 0.05f);
+      params.normalPower = renderer.getParam1f("aoHalfResNormalPower", 8.f);
+      return params;
+    }
+
+    /*! \brief the geometry needed to trace AO rays from a deferred hit */
+    inline DifferentialGeometry getAOSurfaceDG(const AOSurface &surface)
+    {
+      DifferentialGeometry dg;
+      dg.P  = surface.P;
+      dg.Ng = surface.Ng;
+      dg.Ns = surface.Ns;
+      return dg;
+    }
+
+    inline vec3f resolveAO(const AOSurface &surface, float occlusion)
+    {
+      return surface.baseColor + surface.aoWeight * (1.f - occlusion);
+    }
+
+    /*! \brief joint bilateral weight of an AO sample taken at 'src' (at
+     *         pixel offset (dx,dy)) for reconstructing AO at 'dst' */
+    inline float aoUpsampleWeight(const HalfResAOParams &params,
+                                  const AOSurface &dst,
+                                  const AOSurface &src,
+                                  int dx,
+                                  int dy)
+    {
+      // NOTE(jda) - tent over the 3 pixel radius covering the neighboring
+      //             quads, whose AO samples can be anywhere in the quad
+      const float wx = 1.f - ospcommon::abs(float(dx)) / 3.f;
+      const float wy = 1.f - ospcommon::abs(float(dy)) / 3.f;
+
+      if (wx <= 0.f || wy <= 0.f)
+        return 0.f;
+
+      const float cosN = dot(dst.Ns, src.Ns);
+
+      if (cosN <= 0.f)
+        return 0.f;
+
+      const float dz = ospcommon::abs(dst.depth - src.depth) /
+                       (params.depthSigma * dst.depth);
+
+      return wx * wy * ospcommon::fast_exp(-dz * dz) *
+             ospcommon::fast_pow(cosN, params.normalPower);
+    }
+
+    /*! \brief render one job of a tile with AO evaluated at a quarter of
+     *         the primary hits
+
+        Called from a renderer's renderTile(), with
+          - generateFcn(size_t i, int s, ScreenSample &) as
+            Renderer::generateSample()
+          - shadeFcn(ScreenSample &, AOSurface &), which traces the primary
+            ray and shades it except for AO (misses set 'sample.rgb' and
+            leave 'surface.hit' false)
+          - occlusionFcn(const AOSurface &) returning the AO of a hit
+          - writeFcn(size_t i, ScreenSample &) as Renderer::writeSample()
+
+        Pixels of a job are consecutive in z-order, so each aligned group of
+        four is a 2x2 quad inside the job; AO is traced at the first hit of
+        every quad. Pixels without any support from nearby quads (e.g. a
+        silhouette pixel next to background only) trace their own AO. */
+    template <typename GENERATE_FCN,
+              typename SHADE_FCN,
+              typename OCCLUSION_FCN,
+              typename WRITE_FCN>
+    inline void renderJobHalfResAO(const HalfResAOParams &params,
+                                   size_t jobID,
+                                   int spp,
+                                   GENERATE_FCN  &&generateFcn,
+                                   SHADE_FCN     &&shadeFcn,
+                                   OCCLUSION_FCN &&occlusionFcn,
+                                   WRITE_FCN     &&writeFcn)
+    {
+      constexpr int NUM_PIXELS = RENDERTILE_PIXELS_PER_JOB;
+      constexpr int NUM_QUADS  = NUM_PIXELS / 4;
+
+      static_assert(NUM_PIXELS % 4 == 0,
+                    "half resolution AO needs whole 2x2 quads per job");
+
+      const auto begin = jobID * NUM_PIXELS;
+
+      ScreenSample samples[NUM_PIXELS];
+      AOSurface    surfaces[NUM_PIXELS];
+      bool         valid[NUM_PIXELS];
+
+      int   quadSample[NUM_QUADS];
+      float quadOcclusion[NUM_QUADS];
+
+      for (int s = 0; s < spp; s++) {
+        // Primary hits //
+
+        for (int k = 0; k < NUM_PIXELS; ++k) {
+          samples[k]  = ScreenSample{};
+          surfaces[k] = AOSurface{};
+          valid[k]    = generateFcn(begin + k, s, samples[k]);
+          if (valid[k])
+            shadeFcn(samples[k], surfaces[k]);
+        }
+
+        // AO at one hit per quad //
+
+        for (int q = 0; q < NUM_QUADS; ++q) {
+          quadSample[q] = -1;
+          for (int k = 4*q; k < 4*q + 4; ++k) {
+            if (valid[k] && surfaces[k].hit) {
+              quadSample[q]    = k;
+              quadOcclusion[q] = occlusionFcn(surfaces[k]);
+              break;
+            }
+          }
+        }
+
+        // Joint bilateral upsampling //
+
+        for (int k = 0; k < NUM_PIXELS; ++k) {
+          if (!valid[k])
+            continue;
+
+          auto &sample        = samples[k];
+          const auto &surface = surfaces[k];
+
+          if (surface.hit) {
+            float occlusion = 0.f;
+
+            if (quadSample[k/4] == k) {
+              occlusion = quadOcclusion[k/4];
+            } else {
+              float sumWeights   = 0.f;
+              float sumOcclusion = 0.f;
+
+              for (int q = 0; q < NUM_QUADS; ++q) {
+                const int src = quadSample[q];
+                if (src < 0)
+                  continue;
+
+                const int dx = samples[src].sampleID.x - sample.sampleID.x;
+                const int dy = samples[src].sampleID.y - sample.sampleID.y;
+                const float w = aoUpsampleWeight(params, surface,
+                                                 surfaces[src], dx, dy);
+
+                sumWeights   += w;
+                sumOcclusion += w * quadOcclusion[q];
+              }
+
+              occlusion = sumWeights > 1e-3f ? sumOcclusion / sumWeights :
+                                               occlusionFcn(surface);
+            }
+
+            sample.rgb = resolveAO(surface, occlusion);
+          }
+
+          writeFcn(begin + k, sample);
+        }
+      }
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -18,6 +18,8 @@
 #include "SimdSimpleAO.h"
 #include "ao_util_simd.h"
 #include "../../util.h"
+// std
+#include <algorithm>
 
 #define USE_RANDOMTEA_RNG 0
 
@@ -44,6 +46,9 @@ namespace ospray {
 
       //! \brief diffuse texture, if available
       Ref<Texture2D> map_Kd;
+
+      //! \brief mip-mapped copy of map_Kd used for lookups
+      std::shared_ptr<const MipMapTexture> tex_Kd;
     };
 
     void SimdSimpleAOMaterial::commit()
@@ -51,6 +56,7 @@ namespace ospray {
       Kd = getParam3f("color", getParam3f("kd", getParam3f("Kd", vec3f(.8f))));
       map_Kd = (Texture2D*)getParamObject("map_Kd",
                                           getParamObject("map_kd", nullptr));
+      tex_Kd = MipMapTexture::get(map_Kd.ptr);
     }
 
     // SimpleAO definitions ///////////////////////////////////////////////////
@@ -65,40 +71,142 @@ namespace ospray {
       ospray::cpp_renderer::SimdRenderer::commit();
       samplesPerFrame = getParam1i("aoSamples", 1);
       aoRayLength     = getParam1f("aoDistance", 1e20f);
+      regroupAORays   = getParam1i("aoRegroupRays", 1);
+      aoAdaptive      = getAOAdaptiveParams(*this);
+
+      materialTable.build(model, MaterialTable::Entry{},
+        [](const ospray::Material *m, MaterialTable::Entry &e) {
+          auto *mat = dynamic_cast<const SimdSimpleAOMaterial*>(m);
+          if (mat) {
+            e.Kd     = mat->Kd;
+            e.map_Kd = mat->tex_Kd;
+          }
+        }
+      );
     }
 
-    inline void SimdSimpleAORenderer::shade_ao(simd::vmaski active,
-                                               ScreenSampleN &sample) const
+    void SimdSimpleAORenderer::renderTile(void *perFrameData,
+                                          Tile &tile,
+                                          size_t jobID) const
     {
-      auto superColor = simd::make_vec3f(1.f, 1.f, 1.f);
+      // NOTE(jda) - adaptive sampling needs each pixel's hit count between
+      //             batches, so it only regroups within a primary packet
+      if (!regroupAORays || aoAdaptive.enabled) {
+        SimdRenderer::renderTile(perFrameData, tile, jobID);
+        return;
+      }
 
-      auto &ray = sample.ray;
+      constexpr int NUM_PIXELS  = RENDERTILE_PIXELS_PER_JOB;
+      constexpr int NUM_PACKETS = NUM_PIXELS / simd::width;
+
+      static_assert(NUM_PIXELS % simd::width == 0,
+                    "deferred AO needs whole packets per job");
+
+      const auto begin = jobID * NUM_PIXELS;
+
+      ScreenSampleN samples[NUM_PACKETS];
+      simd::vmaski  valid[NUM_PACKETS];
+      simd::vmaski  hit[NUM_PACKETS];
+
+      // NOTE(jda) - the queue lives on this thread's stack for the whole job,
+      //             so AO lanes of all its primary packets are merged
+      DeferredAO deferred;
+
+      for (int s = 0; s < spp; s++) {
+        std::fill(deferred.hits, deferred.hits + NUM_PIXELS, 0);
+
+        // Primary hits, queue their AO rays //
+
+        for (int p = 0; p < NUM_PACKETS; ++p) {
+          auto &sample = samples[p];
+          sample = ScreenSampleN{};
+
+          valid[p] = generateSample(tile, begin + p * simd::width, s, sample);
+          hit[p]   = valid[p];
+
+          if (simd::none(valid[p]))
+            continue;
+
+          hit[p] = traceRay(valid[p], sample.ray);
+
+          if (simd::any(hit[p]))
+            queue_ao(hit[p], sample, p * simd::width, deferred);
+          else
+            sample.rgb = simd::vec3f{bgColor};
+        }
+
+        flush_ao(deferred);
+
+        // Resolve occlusion //
+
+        for (int p = 0; p < NUM_PACKETS; ++p) {
+          if (simd::none(valid[p]))
+            continue;
+
+          auto &sample = samples[p];
 
-      auto dg = postIntersect(active, ray,
-                              DG_NG|DG_NS|DG_NORMALIZE|DG_FACEFORWARD|
-                              DG_MATERIALID|DG_COLOR|DG_TEXCOORD);
-
-      simd::foreach_active(active, [&](int i) {
-        auto *mat = dynamic_cast<SimdSimpleAOMaterial*>(dg.material[i]);
-
-        if (mat) {
-          superColor.x[i] = mat->Kd.x;
-          superColor.y[i] = mat->Kd.y;
-          superColor.z[i] = mat->Kd.z;
-#if 0// NOTE(jda) - texture fetches not yet implemented
-          if (mat->map_Kd) {
-            vec4f Kd_from_map = get4f(mat->map_Kd, dg.st);
-            superColor = superColor *
-                vec3f(Kd_from_map.x, Kd_from_map.y, Kd_from_map.z);
+          if (samplesPerFrame > 0 && simd::any(hit[p])) {
+            const auto hits = simd::cast<simd::vfloat>(
+                simd::load<simd::vint>(&deferred.hits[p * simd::width]));
+            sample.rgb = simd::select(hit[p],
+                                      sample.rgb *
+                                      (1.f - hits / float(samplesPerFrame)),
+                                      sample.rgb);
           }
-#endif
+
+          writeSample(tile, begin + p * simd::width, valid[p], sample);
         }
-      });
+      }
+
+      countTraced(deferred.queue);
+    }
+
+    void SimdSimpleAORenderer::endFrame(void *perFrameData,
+                                        const int32 fbChannelFlags)
+    {
+      SimdRenderer::endFrame(perFrameData, fbChannelFlags);
+
+      const size_t packets = aoPacketsTraced.exchange(0);
+      const size_t lanes   = aoLanesTraced.exchange(0);
+
+      if (logLevel() >= 2 && packets > 0) {
+        std::cout << "ospray: cpp_ao_simd traced " << lanes << " AO rays in "
+                  << packets << " packets ("
+                  << 100.f * lanes / (packets * simd::width)
+                  << "% SIMD utilization)" << std::endl;
+      }
+    }
+
+    inline simd::vec3f
+    SimdSimpleAORenderer::shade_surface(simd::vmaski active,
+                                        const RayN &ray,
+                                        DifferentialGeometryN &dg) const
+    {
+      dg = postIntersect(active, ray,
+                         DG_NG|DG_NS|DG_NORMALIZE|DG_FACEFORWARD|
+                         DG_MATERIALID|DG_COLOR|DG_TEXCOORD);
+
+      auto superColor = materialTable.Kd(active, dg.materialID);
+      const auto Kd_from_map = materialTable.map_Kd(active, dg.materialID,
+                                                    dg.st, dg.stWidth);
+      superColor *= simd::vec3f{Kd_from_map.x, Kd_from_map.y, Kd_from_map.z};
 
       // should be done in material:
       superColor *= simd::vec3f{dg.color.x, dg.color.y, dg.color.z};
 
+      return superColor * simd::abs(dot(dg.Ns, ray.dir));
+    }
+
+    inline void SimdSimpleAORenderer::shade_ao(simd::vmaski active,
+                                               ScreenSampleN &sample) const
+    {
+      auto &ray = sample.ray;
+
+      DifferentialGeometryN dg;
+      const auto surfaceColor = shade_surface(active, ray, dg);
+
       simd::vfloat hits {0.f};
+      simd::vfloat samples {0.f};
       auto aoContext = getAOContext(dg, aoRayLength, epsilon);
 
 #if USE_RANDOMTEA_RNG
@@ -110,7 +218,30 @@ namespace ospray {
       simd::RandomTEA<simd::vint,4> rng((pixel_y * fbWidth) + pixel_x, accumID);
 #endif
 
-      for (int i = 0; i < samplesPerFrame; i++) {
+      // NOTE(jda) - when regrouping, live lanes of all AO packets are queued
+      //             into dense packets, lanes resolved by the grazing angle
+      //             test are never traced; hit counts are scattered back per
+      //             lane of the primary packet
+      OcclusionQueueN queue;
+      OSPRAY_ALIGN(64) int laneHits[simd::width] = {0};
+
+      auto traceQueue = [&]() {
+        queue.flush(
+          [&](simd::vmaski queueActive, RayN &rays) {
+            return isOccluded(queueActive, rays);
+          },
+          [&](int lane, bool occluded) {
+            if (occluded)
+              laneHits[lane]++;
+          }
+        );
+      };
+
+      // NOTE(jda) - with adaptive sampling, lanes drop out of 'live' at the
+      //             end of each batch once their estimate has converged
+      auto live = active;
+
+      for (int i = 0; i < samplesPerFrame && simd::any(live); i++) {
 #if USE_RANDOMTEA_RNG
         auto ao_ray = calculateAORay(dg, aoContext, rng);
 #else
@@ -118,27 +249,116 @@ namespace ospray {
 #endif
         ao_ray.t = aoRayLength;
 
-        auto rayOccluded = isOccluded(active, ao_ray) |
-                           dot(ao_ray.dir, dg.Ns) < 0.05f;
+        auto grazing = dot(ao_ray.dir, dg.Ns) < 0.05f;
+
+        if (regroupAORays) {
+          simd::foreach_active(live, [&](int lane) {
+            if (grazing[lane])
+              laneHits[lane]++;
+            else if (queue.push(ao_ray, lane, lane))
+              traceQueue();
+          });
+        } else {
+          auto rayOccluded = (isOccluded(live, ao_ray) | grazing) & live;
+          hits = simd::select(rayOccluded, hits+1, hits);
+        }
+
+        samples = simd::select(live, samples+1, samples);
+
+        if (aoAdaptive.enabled && (i + 1) % aoAdaptive.batchSize == 0) {
+          if (regroupAORays) {
+            traceQueue();
+            hits = simd::cast<simd::vfloat>(simd::load<simd::vint>(laneHits));
+          }
 
-        hits = simd::select(rayOccluded, hits+1, hits);
+          live = live & !aoConverged(hits, samples,
+                                     aoAdaptive.varianceThreshold);
+        }
       }
 
-      auto diffuse = simd::abs(dot(dg.Ns, ray.dir));
+      if (regroupAORays) {
+        traceQueue();
+        hits = simd::cast<simd::vfloat>(simd::load<simd::vint>(laneHits));
+        countTraced(queue);
+      }
 
       auto &color = sample.rgb;
 
       if (samplesPerFrame > 0) {
         color = simd::select(active,
-                             superColor*(diffuse * (1.f-hits/samplesPerFrame)),
+                             surfaceColor * (1.f-hits/samples),
                              simd::vec3f{bgColor});
       } else {
-        color = simd::select(active, superColor*diffuse, simd::vec3f{bgColor});
+        color = simd::select(active, surfaceColor, simd::vec3f{bgColor});
       }
 
       sample.alpha = simd::select(active, simd::vfloat{1.f}, sample.alpha);
     }
 
+    inline void SimdSimpleAORenderer::queue_ao(simd::vmaski active,
+                                               ScreenSampleN &sample,
+                                               int firstPixel,
+                                               DeferredAO &deferred) const
+    {
+      auto &ray = sample.ray;
+
+      DifferentialGeometryN dg;
+      const auto surfaceColor = shade_surface(active, ray, dg);
+
+      auto aoContext = getAOContext(dg, aoRayLength, epsilon);
+
+#if USE_RANDOMTEA_RNG
+      const auto &fbWidth = currentFB->size.x;
+      const auto pixel_x = sample.sampleID.x;
+      const auto pixel_y = sample.sampleID.y;
+      const auto accumID = sample.sampleID.z;
+
+      simd::RandomTEA<simd::vint,4> rng((pixel_y * fbWidth) + pixel_x, accumID);
+#endif
+
+      for (int i = 0; i < samplesPerFrame; i++) {
+#if USE_RANDOMTEA_RNG
+        auto ao_ray = calculateAORay(dg, aoContext, rng);
+#else
+        auto ao_ray = calculateAORay(dg, aoContext);
+#endif
+        ao_ray.t = aoRayLength;
+
+        auto grazing = dot(ao_ray.dir, dg.Ns) < 0.05f;
+
+        simd::foreach_active(active, [&](int lane) {
+          const int pixel = firstPixel + lane;
+          if (grazing[lane])
+            deferred.hits[pixel]++;
+          else if (deferred.queue.push(ao_ray, lane, pixel))
+            flush_ao(deferred);
+        });
+      }
+
+      // NOTE(jda) - occlusion is applied once the job's queries are traced
+      sample.rgb   = simd::select(active, surfaceColor, simd::vec3f{bgColor});
+      sample.alpha = simd::select(active, simd::vfloat{1.f}, sample.alpha);
+    }
+
+    void SimdSimpleAORenderer::flush_ao(DeferredAO &deferred) const
+    {
+      deferred.queue.flush(
+        [&](simd::vmaski queueActive, RayN &rays) {
+          return isOccluded(queueActive, rays);
+        },
+        [&](int pixel, bool occluded) {
+          if (occluded)
+            deferred.hits[pixel]++;
+        }
+      );
+    }
+
+    void SimdSimpleAORenderer::countTraced(const OcclusionQueueN &queue) const
+    {
+      aoPacketsTraced += queue.packetsTraced;
+      aoLanesTraced   += queue.lanesTraced;
+    }
+
     void SimdSimpleAORenderer::renderSample(simd::vmaski active,
                                             void *perFrameData,
                                             ScreenSampleN &sample) const
@@ -17,6 +17,10 @@
 #pragma once
 
 #include "../SimdRenderer.h"
+#include "../../common/OcclusionQueueN.h"
+#include "ao_util_simd.h"
+// std
+#include <atomic>
 
 namespace ospray {
   namespace cpp_renderer {
@@ -26,6 +30,12 @@ namespace ospray {
       std::string toString() const override;
       void commit() override;
 
+      void renderTile(void *perFrameData,
+                      Tile &tile,
+                      size_t jobID) const override;
+
+      void endFrame(void *perFrameData, const int32 fbChannelFlags) override;
+
       void renderSample(simd::vmaski active,
                         void *perFrameData,
                         ScreenSampleN &sample) const override;
@@ -34,10 +44,43 @@ namespace ospray {
 
     private:
 
+      /*! \brief AO queries of all primary packets of a job, traced once
+       *         simd::width of them are queued */
+      struct DeferredAO
+      {
+        OcclusionQueueN queue;
+        int hits[RENDERTILE_PIXELS_PER_JOB];
+      };
+
+      //! shading of the hits in 'active' without AO, also returns their dg
+      simd::vec3f shade_surface(simd::vmaski active,
+                                const RayN &ray,
+                                DifferentialGeometryN &dg) const;
+
       void shade_ao(simd::vmaski active, ScreenSampleN &sample) const;
 
+      /*! \brief shade the hits in 'active' and queue their AO rays in
+       *         'deferred', pixel 'firstPixel' + lane of the job */
+      void queue_ao(simd::vmaski active,
+                    ScreenSampleN &sample,
+                    int firstPixel,
+                    DeferredAO &deferred) const;
+
+      void flush_ao(DeferredAO &deferred) const;
+
+      //! add the occlusion queries traced by 'queue' to the frame totals
+      void countTraced(const OcclusionQueueN &queue) const;
+
       int   samplesPerFrame{1};
       float aoRayLength{1e20f};
+      bool  regroupAORays{true};
+
+      ao_adaptive aoAdaptive;
+
+      // NOTE(jda) - aoLanesTraced / (aoPacketsTraced * simd::width) is the
+      //             SIMD utilization of the regrouped AO queries
+      mutable std::atomic<size_t> aoPacketsTraced {0};
+      mutable std::atomic<size_t> aoLanesTraced {0};
     };
 
   }// namespace cpp_renderer
@@ -42,6 +42,9 @@ namespace ospray {
 
       //! \brief diffuse texture, if available
       Ref<Texture2D> map_Kd;
+
+      //! \brief mip-mapped copy of map_Kd used for lookups
+      std::shared_ptr<const MipMapTexture> tex_Kd;
     };
 
     void SimpleAOMaterial::commit()
@@ -49,6 +52,7 @@ namespace ospray {
       Kd = getParam3f("color", getParam3f("kd", getParam3f("Kd", vec3f(.8f))));
       map_Kd = (Texture2D*)getParamObject("map_Kd",
                                           getParamObject("map_kd", nullptr));
+      tex_Kd = MipMapTexture::get(map_Kd.ptr);
     }
 
     // SimpleAO definitions ///////////////////////////////////////////////////
@@ -63,46 +67,143 @@ namespace ospray {
       ospray::cpp_renderer::Renderer::commit();
       samplesPerFrame = getParam1i("aoSamples", 1);
       aoRayLength     = getParam1f("aoDistance", 1e20f);
+      aoAdaptive      = getAOAdaptiveParams(*this);
+      halfResAO       = getHalfResAOParams(*this);
+
+      const float defaultCellSize =
+          model ? defaultAOCacheCellSize(model->bounds) : 1.f;
+
+      aoCache.update(getParam1i("aoCache", 0),
+                     model,
+                     aoRayLength,
+                     getParam1i("aoCacheLog2Size", 22),
+                     getParam1f("aoCacheCellSize", defaultCellSize),
+                     getParam1i("aoCacheSamples", 256));
+
+      voxelAO.update(getParam1i("aoVoxel", 0),
+                     model,
+                     getParam1i("aoVoxelResolution", 256),
+                     getParam1i("aoVoxelCones", 6));
+
+      aoBake = getParam1i("aoBake", 0);
+
+      if (aoBake && model) {
+        VertexBakeSettings bake;
+        bake.aoSamples  = getParam1i("aoBakeSamples", 64);
+        bake.aoDistance = aoRayLength;
+        bakeVertexLighting(model, bake);
+      }
     }
 
-    inline void SimpleAORenderer::shade_ao(ScreenSample &sample) const
+    inline void SimpleAORenderer::shade_surface(ScreenSample &sample,
+                                                AOSurface &surface) const
     {
       vec3f superColor{1.f};
-      auto &color = sample.rgb;
-      auto &ray   = sample.ray;
+      auto &ray = sample.ray;
 
       auto dg = postIntersect(ray, DG_NG|DG_NS|DG_NORMALIZE|DG_FACEFORWARD|
-                                   DG_MATERIALID|DG_COLOR|DG_TEXCOORD);
+                                   DG_MATERIALID|DG_COLOR|DG_TEXCOORD|
+                                   (aoBake ? DG_BAKED : 0));
 
       auto *mat = dynamic_cast<SimpleAOMaterial*>(dg.material);
 
       if (mat) {
         superColor = mat->Kd;
-#if 0// NOTE(jda) - texture fetches not yet implemented
-        if (mat->map_Kd) {
-          vec4f Kd_from_map = get4f(mat->map_Kd, dg.st);
+        if (mat->tex_Kd) {
+          vec4f Kd_from_map = mat->tex_Kd->sample(dg.st, dg.stWidth);
           superColor = superColor *
               vec3f(Kd_from_map.x, Kd_from_map.y, Kd_from_map.z);
         }
-#endif
       }
 
       // should be done in material:
       superColor *= vec3f{dg.color.x, dg.color.y, dg.color.z};
 
-      int hits = 0;
+      float diffuse = ospcommon::abs(dot(dg.Ns, ray.dir));
+
+      surface.hit      = true;
+      surface.depth    = ray.t;
+      surface.P        = dg.P;
+      surface.Ng       = dg.Ng;
+      surface.Ns       = dg.Ns;
+      surface.aoWeight = superColor * diffuse;
+      surface.bakedAO  = dg.bakedAO;
+
+      sample.alpha = 1.f;
+
+      if (denoiser.enabled()) {
+        denoiser.setGuides(sample.sampleID.x, sample.sampleID.y,
+                           ray.t, dg.Ns, superColor);
+      }
+    }
+
+    inline float SimpleAORenderer::occlusion(const AOSurface &surface) const
+    {
+      // NOTE(jda) - interpolated from the per-vertex bake, if the hit
+      //             geometry has one
+      if (surface.bakedAO >= 0.f)
+        return surface.bakedAO;
+
+      // NOTE(jda) - cone traced AO approximation, no rays are traced at all
+      if (voxelAO.enabled())
+        return voxelAO.occlusion(surface.P, surface.Ns, aoRayLength);
+
+      const auto dg = getAOSurfaceDG(surface);
+
       auto aoContext = getAOContext(dg, aoRayLength, epsilon);
 
-      for (int i = 0; i < samplesPerFrame; i++) {
-        auto ao_ray = calculateAORay(dg, aoContext);
-        ao_ray.t = aoRayLength;
-        if (dot(ao_ray.dir, dg.Ns) < 0.05f || isOccluded(ao_ray))
-          hits++;
+      auto traceSamples = [&](int numSamples) {
+        int hits = 0;
+        // NOTE(jda) - a single AO ray is cheaper to trace on its own
+        if (numSamples > 1) {
+          hits = traceAOPacketBundle(dg, aoContext, dg.Ns, aoRayLength,
+                                     numSamples,
+                                     [&](simd::vmaski active, RayN &rays) {
+                                       return isOccluded(active, rays);
+                                     });
+        } else {
+          for (int i = 0; i < numSamples; i++) {
+            auto ao_ray = calculateAORay(dg, aoContext);
+            ao_ray.t = aoRayLength;
+            if (dot(ao_ray.dir, dg.Ns) < 0.05f || isOccluded(ao_ray))
+              hits++;
+          }
+        }
+        return hits;
+      };
+
+      return aoCache.enabled() ?
+          aoCache.occlusion(dg.P, dg.Ns, samplesPerFrame, traceSamples) :
+          adaptiveOcclusion(aoAdaptive, samplesPerFrame, traceSamples);
+    }
+
+    void SimpleAORenderer::renderTile(void *perFrameData,
+                                      Tile &tile,
+                                      size_t jobID) const
+    {
+      if (!halfResAO.enabled) {
+        Renderer::renderTile(perFrameData, tile, jobID);
+        return;
       }
 
-      float diffuse = ospcommon::abs(dot(dg.Ns, ray.dir));
-      color = superColor * (diffuse * (1.0f-float(hits)/samplesPerFrame));
-      sample.alpha = 1.f;
+      renderJobHalfResAO(
+        halfResAO, jobID, spp,
+        [&](size_t i, int s, ScreenSample &sample) {
+          return generateSample(tile, i, s, sample);
+        },
+        [&](ScreenSample &sample, AOSurface &surface) {
+          if (traceRay(sample.ray))
+            shade_surface(sample, surface);
+          else
+            sample.rgb = bgColor;
+        },
+        [&](const AOSurface &surface) {
+          return occlusion(surface);
+        },
+        [&](size_t i, ScreenSample &sample) {
+          writeSample(tile, i, sample);
+        }
+      );
     }
 
     void SimpleAORenderer::renderSample(void *perFrameData,
@@ -111,7 +212,9 @@ namespace ospray {
       UNUSED(perFrameData);
 
       if (traceRay(sample.ray)) {
-        shade_ao(sample);
+        AOSurface surface;
+        shade_surface(sample, surface);
+        sample.rgb = resolveAO(surface, occlusion(surface));
       } else {
         sample.rgb = bgColor;
       }
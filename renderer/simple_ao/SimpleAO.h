@@ -17,6 +17,11 @@
 #pragma once
 
 #include "../Renderer.h"
+#include "AOCache.h"
+#include "HalfResAO.h"
+#include "VertexBaker.h"
+#include "VoxelAO.h"
+#include "ao_util.h"
 
 namespace ospray {
   namespace cpp_renderer {
@@ -26,6 +31,10 @@ namespace ospray {
       std::string toString() const override;
       void commit() override;
 
+      void renderTile(void *perFrameData,
+                      Tile &tile,
+                      size_t jobID) const override;
+
       void renderSample(void *perFrameData,
                         ScreenSample &sample) const override;
 
@@ -33,10 +42,19 @@ namespace ospray {
 
     private:
 
-      void shade_ao(ScreenSample &sample) const;
+      //! \brief shade a hit, except for AO
+      void shade_surface(ScreenSample &sample, AOSurface &surface) const;
+
+      float occlusion(const AOSurface &surface) const;
 
       int   samplesPerFrame{1};
       float aoRayLength{1e20f};
+      bool  aoBake{false};
+
+      ao_adaptive     aoAdaptive;
+      HalfResAOParams halfResAO;
+      AOCache         aoCache;
+      VoxelAO         voxelAO;
     };
 
   }// namespace cpp_renderer
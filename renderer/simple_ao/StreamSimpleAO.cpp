@@ -46,6 +46,9 @@ namespace ospray {
 
       //! \brief diffuse texture, if available
       Ref<Texture2D> map_Kd;
+
+      //! \brief mip-mapped copy of map_Kd used for lookups
+      std::shared_ptr<const MipMapTexture> tex_Kd;
     };
 
     void StreamSimpleAOMaterial::commit()
@@ -53,6 +56,7 @@ namespace ospray {
       Kd = getParam3f("color", getParam3f("kd", getParam3f("Kd", vec3f(.8f))));
       map_Kd = (Texture2D*)getParamObject("map_Kd",
                                           getParamObject("map_kd", nullptr));
+      tex_Kd = MipMapTexture::get(map_Kd.ptr);
     }
 
     // StreamSimpleAO definitions /////////////////////////////////////////////
@@ -67,6 +71,7 @@ namespace ospray {
       ospray::cpp_renderer::Renderer::commit();
       samplesPerFrame = getParam1i("aoSamples", 1);
       aoRayLength     = getParam1f("aoDistance", 1e20f);
+      aoAdaptive      = getAOAdaptiveParams(*this);
     }
 
     void StreamSimpleAORenderer::renderStream(void */*perFrameData*/,
@@ -107,13 +112,11 @@ namespace ospray {
 
           if (mat) {
             sample.rgb = mat->Kd;
-#if 0// NOTE(jda) - texture fetches not yet implemented
-            if (mat->map_Kd) {
-              vec4f Kd_from_map = get4f(mat->map_Kd, dg.st);
-              sample.rgbcolor *=
+            if (mat->tex_Kd) {
+              vec4f Kd_from_map = mat->tex_Kd->sample(dg.st, dg.stWidth);
+              sample.rgb *=
                   vec3f(Kd_from_map.x, Kd_from_map.y, Kd_from_map.z);
             }
-#endif
           } else {
             sample.rgb = vec3f{1.f};
           }
@@ -127,15 +130,31 @@ namespace ospray {
       Stream<int> hits;
       std::fill(begin(hits), end(hits), 0);
 
+      Stream<int> samples;
+      std::fill(begin(samples), end(samples), 0);
+
+      // NOTE(jda) - with adaptive sampling, samples whose estimate converged
+      //             stop tracing AO rays; their rays are disabled so the
+      //             remaining (active) rays still go out as one stream
+      Stream<int> converged;
+      std::fill(begin(converged), end(converged), 0);
+
+      int nActiveAO = nActiveRays;
+
       Stream<ao_context> ao_ctxs;
 
       RayStream ao_rays;
 
-      for (int j = 0; j < samplesPerFrame; j++) {
+      for (int j = 0; j < samplesPerFrame && nActiveAO > 0; j++) {
         // Setup AO rays for active "lanes"
         for_each_sample_i(
           stream,
           [&](ScreenSampleRef /*sample*/, int i) {
+            if (converged[i]) {
+              disableRay(ao_rays, i);
+              return;
+            }
+
             auto &dg  = dgs[i];
             auto &ctx = ao_ctxs[i];
             ctx = getAOContext(dg, aoRayLength, epsilon);
@@ -147,15 +166,30 @@ namespace ospray {
         // Trace AO rays
         occludeRays(ao_rays, RTC_INTERSECT_INCOHERENT);
 
+        const bool endOfBatch = aoAdaptive.enabled &&
+                                (j + 1) % aoAdaptive.batchSize == 0;
+
         // Record occlusion test
         for_each_sample_i(
           stream,
           [&](ScreenSampleRef sample, int i) {
             UNUSED(sample);
+
+            if (converged[i])
+              return;
+
             auto &ao_ray = ao_rays[i];
             ao_ray.t = aoRayLength;
             if (dot(ao_ray.dir, dgs[i].Ng) < 0.05f || ao_ray.hitSomething())
               hits[i]++;
+
+            samples[i]++;
+
+            if (endOfBatch && aoConverged(hits[i], samples[i],
+                                          aoAdaptive.varianceThreshold)) {
+              converged[i] = 1;
+              nActiveAO--;
+            }
           },
           rayHit
         );
@@ -166,7 +200,9 @@ namespace ospray {
         stream,
         [&](ScreenSampleRef sample, int i) {
           float diffuse = ospcommon::abs(dot(dgs[i].Ng, sample.ray.dir));
-          sample.rgb *= diffuse * (1.0f - float(hits[i])/samplesPerFrame);
+          const float occlusion =
+              samples[i] > 0 ? float(hits[i]) / samples[i] : 0.f;
+          sample.rgb *= diffuse * (1.0f - occlusion);
         },
         rayHit
       );
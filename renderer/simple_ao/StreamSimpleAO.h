@@ -17,6 +17,7 @@
 #pragma once
 
 #include "../StreamRenderer.h"
+#include "ao_util.h"
 
 namespace ospray {
   namespace cpp_renderer {
@@ -35,6 +36,8 @@ namespace ospray {
 
       int   samplesPerFrame{1};
       float aoRayLength{1e20f};
+
+      ao_adaptive aoAdaptive;
     };
 
   }// namespace cpp_renderer
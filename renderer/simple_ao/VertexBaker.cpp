@@ -0,0 +1,242 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "VertexBaker.h"
+#include "ao_util.h"
+#include "../../geometry/TriangleMesh.h"
+// ospray
+#include "ospcommon/tasking/parallel_for.h"
+// embree
+#include "embree2/rtcore.h"
+#include "embree2/rtcore_scene.h"
+// std
+#include <cstring>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // Helper functions ///////////////////////////////////////////////////////
+
+    static inline uint64_t hashCombine(uint64_t h, uint64_t v)
+    {
+      h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+      return h;
+    }
+
+    static inline uint64_t floatBits(float f)
+    {
+      uint32_t bits;
+      std::memcpy(&bits, &f, sizeof(bits));
+      return bits;
+    }
+
+    static uint64_t computeBakeKey(const TriangleMesh &mesh,
+                                   const VertexBakeSettings &settings,
+                                   int numLights)
+    {
+      uint64_t key = 0xcbf29ce484222325ull;
+
+      // NOTE(jda) - not the array pointers, which stay the same when a
+      //             shared array is updated in place and recommitted
+      key = hashCombine(key, mesh.version);
+      key = hashCombine(key, mesh.numVerts);
+      key = hashCombine(key, mesh.numTris);
+      key = hashCombine(key, settings.aoSamples);
+      key = hashCombine(key, floatBits(settings.aoDistance));
+
+      for (int l = 0; l < numLights; ++l) {
+        const auto &dir = settings.lightDirections[l];
+        key = hashCombine(key, floatBits(dir.x));
+        key = hashCombine(key, floatBits(dir.y));
+        key = hashCombine(key, floatBits(dir.z));
+      }
+
+      // NOTE(jda) - 0 is reserved for "not baked"
+      return key == 0 ? 1 : key;
+    }
+
+    static inline void occludeStream(RTCScene scene, RayStream &rays)
+    {
+#if USE_EMBREE_STREAMS
+      RTCIntersectContext ctx{RTC_INTERSECT_INCOHERENT, nullptr};
+      rtcOccluded1M(scene, &ctx, (RTCRay*)&rays, rays.size(), sizeof(Ray));
+#else
+      for (int i = 0; i < STREAM_SIZE; ++i) {
+        auto &ray = rays[i];
+        if (rayIsActive(ray))
+          rtcOccluded(scene, reinterpret_cast<RTCRay&>(ray));
+      }
+#endif
+    }
+
+    //! vertex normals of 'mesh', area weighted face normals if it has none
+    static std::vector<vec3f> computeVertexNormals(const TriangleMesh &mesh)
+    {
+      std::vector<vec3f> normals(mesh.numVerts, vec3f(0.f));
+
+      if (mesh.normal) {
+        for (size_t v = 0; v < mesh.numVerts; ++v) {
+          normals[v] =
+              reinterpret_cast<const vec3f&>(mesh.normal[v * mesh.norSize]);
+        }
+      } else {
+        auto vertex = [&](int v) -> const vec3f& {
+          return reinterpret_cast<const vec3f&>(mesh.vertex[v * mesh.vtxSize]);
+        };
+
+        for (size_t t = 0; t < mesh.numTris; ++t) {
+          const int *idx = mesh.index + mesh.idxSize * t;
+          const vec3f n  = cross(vertex(idx[1]) - vertex(idx[0]),
+                                 vertex(idx[2]) - vertex(idx[0]));
+          normals[idx[0]] += n;
+          normals[idx[1]] += n;
+          normals[idx[2]] += n;
+        }
+      }
+
+      for (auto &n : normals) {
+        const float len2 = dot(n, n);
+        n = len2 > 0.f ? n * rsqrt(len2) : vec3f(0.f, 0.f, 1.f);
+      }
+
+      return normals;
+    }
+
+    static void bakeMesh(TriangleMesh &mesh,
+                         RTCScene scene,
+                         float epsilon,
+                         const VertexBakeSettings &settings,
+                         int numLights)
+    {
+      const auto normals = computeVertexNormals(mesh);
+
+      const int aoSamples = std::max(settings.aoSamples, 0);
+
+      mesh.bakedAO.assign(mesh.numVerts, 0.f);
+      mesh.bakedLightVisibility.assign(mesh.numVerts * numLights, 1.f);
+      mesh.numBakedLights = numLights;
+
+      const int numChunks = (mesh.numVerts + STREAM_SIZE - 1) / STREAM_SIZE;
+
+      tasking::parallel_for(numChunks, [&](int chunk) {
+        const size_t first = size_t(chunk) * STREAM_SIZE;
+        const int    n     = std::min<size_t>(STREAM_SIZE,
+                                              mesh.numVerts - first);
+
+        Stream<DifferentialGeometry> dgs;
+        Stream<ao_context> ctxs;
+        Stream<int> hits;
+        hits.fill(0);
+
+        for (int i = 0; i < n; ++i) {
+          const size_t v = first + i;
+          auto &dg = dgs[i];
+          dg.P  = reinterpret_cast<const vec3f&>(mesh.vertex[v*mesh.vtxSize]);
+          dg.Ng = dg.Ns = normals[v];
+          ctxs[i] = getAOContext(dg, settings.aoDistance);
+        }
+
+        RayStream rays;
+
+        // Ambient occlusion //
+
+        for (int s = 0; s < aoSamples; ++s) {
+          for (int i = 0; i < n; ++i) {
+            rays[i] = calculateAORay(dgs[i], ctxs[i]);
+            rays[i].org = dgs[i].P + epsilon * dgs[i].Ng;
+          }
+
+          occludeStream(scene, rays);
+
+          for (int i = 0; i < n; ++i) {
+            if (dot(rays[i].dir, dgs[i].Ng) < 0.05f || rays[i].hitSomething())
+              hits[i]++;
+          }
+        }
+
+        for (int i = 0; i < n; ++i) {
+          mesh.bakedAO[first + i] =
+              aoSamples > 0 ? float(hits[i]) / aoSamples : 0.f;
+        }
+
+        // Light visibility //
+
+        for (int l = 0; l < numLights; ++l) {
+          const vec3f &dir = settings.lightDirections[l];
+
+          for (int i = 0; i < n; ++i) {
+            Ray ray;
+            ray.org = dgs[i].P + epsilon * dgs[i].Ng;
+            ray.dir = dir;
+            ray.t0  = 0.f;
+            ray.t   = inf;
+            rays[i] = ray;
+          }
+
+          occludeStream(scene, rays);
+
+          for (int i = 0; i < n; ++i) {
+            if (rays[i].hitSomething())
+              mesh.bakedLightVisibility[(first + i) * numLights + l] = 0.f;
+          }
+        }
+      });
+    }
+
+    // Baking entry point /////////////////////////////////////////////////////
+
+    int bakeVertexLighting(Model *model, const VertexBakeSettings &settings)
+    {
+      if (model == nullptr || model->embreeSceneHandle == nullptr)
+        return 0;
+
+      const int numLights = std::min(int(settings.lightDirections.size()),
+                                     DG_MAX_BAKED_LIGHTS);
+
+      // NOTE(jda) - offset ray origins relative to the scene size, vertices
+      //             sit exactly on the surfaces they are occluded by
+      const float epsilon = 1e-4f * length(model->bounds.size());
+
+      int numBaked = 0;
+
+      for (auto &g : model->geometry) {
+        auto *mesh = dynamic_cast<TriangleMesh*>(g.ptr);
+
+        if (mesh == nullptr || mesh->numVerts == 0)
+          continue;
+
+        const uint64_t key = computeBakeKey(*mesh, settings, numLights);
+
+        if (mesh->bakeKey == key)
+          continue;
+
+        bakeMesh(*mesh, model->embreeSceneHandle, epsilon, settings,
+                 numLights);
+
+        mesh->bakeKey = key;
+        numBaked++;
+      }
+
+      if (logLevel() >= 2 && numBaked > 0) {
+        std::cout << "ospray: baked per-vertex lighting of " << numBaked
+                  << " triangle mesh(es)" << std::endl;
+      }
+
+      return numBaked;
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
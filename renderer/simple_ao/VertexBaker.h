@@ -0,0 +1,53 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "common/Model.h"
+// std
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief inputs of a per-vertex lighting bake */
+    struct VertexBakeSettings
+    {
+      int   aoSamples {64};
+      float aoDistance {1e20f};
+
+      //! directions *towards* distant lights whose visibility is baked, at
+      //  most DG_MAX_BAKED_LIGHTS
+      std::vector<vec3f> lightDirections;
+    };
+
+    /*! \brief bake AO (and visibility of distant lights) per vertex of every
+     *         TriangleMesh of 'model'
+
+        Occlusion rays of a chunk of STREAM_SIZE vertices are traced as one
+        ray stream, chunks are baked in parallel. Results are stored in the
+        mesh (TriangleMesh::bakedAO etc.) and picked up by postIntersect()
+        with DG_BAKED.
+
+        The bake is incremental: a mesh is skipped if it was already baked
+        with the same settings and vertex data, so adding a mesh to the
+        model only bakes the new one (the existing meshes' bakes don't see
+        the new occluder). Returns the number of meshes baked. */
+    int bakeVertexLighting(Model *model, const VertexBakeSettings &settings);
+
+  }// namespace cpp_renderer
+}// namespace ospray
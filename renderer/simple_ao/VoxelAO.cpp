@@ -0,0 +1,361 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "VoxelAO.h"
+#include "ao_util.h"
+#include "../../geometry/TriangleMesh.h"
+// ospray
+#include "ospcommon/tasking/parallel_for.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // Helper functions ///////////////////////////////////////////////////////
+
+    static inline size_t voxelIndex(const vec3i &dims, int x, int y, int z)
+    {
+      return (size_t(z) * dims.y + y) * dims.x + x;
+    }
+
+    static inline vec3f triangleVertex(const TriangleMesh &mesh, size_t tri,
+                                       int corner)
+    {
+      const int v = mesh.index[mesh.idxSize * tri + corner];
+      return reinterpret_cast<const vec3f&>(mesh.vertex[v * mesh.vtxSize]);
+    }
+
+    /*! range of j in [jBegin, jEnd] for which z0 + j * dz lies in
+        [lower, upper], rounded outwards; false if there is none */
+    static inline bool sampleRange(float z0, float dz,
+                                   float lower, float upper,
+                                   int &jBegin, int &jEnd)
+    {
+      if (std::abs(dz) < 1e-20f)
+        return z0 >= lower && z0 <= upper;
+
+      const float j0 = (lower - z0) / dz;
+      const float j1 = (upper - z0) / dz;
+
+      const float lo = std::max(std::min(j0, j1), float(jBegin));
+      const float hi = std::min(std::max(j0, j1), float(jEnd));
+
+      if (!(lo <= hi))
+        return false;
+
+      jBegin = int(floorf(lo));
+      jEnd   = int(ceilf(hi));
+      return true;
+    }
+
+    // VoxelAO definitions ////////////////////////////////////////////////////
+
+    void VoxelAO::update(bool enable, const Model *model, int resolution,
+                         int numCones)
+    {
+      const bool unchanged = enable     == settings.enable     &&
+                             model      == settings.model      &&
+                             resolution == settings.resolution &&
+                             numCones   == settings.numCones;
+
+      if (unchanged)
+        return;
+
+      settings.enable     = enable;
+      settings.model      = model;
+      settings.resolution = resolution;
+      settings.numCones   = numCones;
+
+      levels.clear();
+
+      if (enable && model != nullptr &&
+          reduce_max(model->bounds.size()) > 0.f) {
+        buildCones(numCones);
+        build(model, ospcommon::clamp(resolution, 16, 1024));
+      }
+    }
+
+    void VoxelAO::buildCones(int numCones)
+    {
+      // NOTE(jda) - one cone along the normal and a ring of cones at 60
+      //             degrees; the aperture shrinks as cones are added so they
+      //             keep covering the hemisphere without much overlap
+      numCones = ospcommon::clamp(numCones, 1, 16);
+
+      cones.clear();
+      cones.push_back({vec3f(0.f, 0.f, 1.f), 1.f});
+
+      const int   ringCones = numCones - 1;
+      const float sinTheta  = 0.866025f;
+      const float cosTheta  = 0.5f;
+
+      for (int i = 0; i < ringCones; ++i) {
+        float s, c;
+        ospcommon::fast_sincos(float(2.0 * M_PI) * i / ringCones, s, c);
+        cones.push_back({vec3f(c * sinTheta, s * sinTheta, cosTheta),
+                         cosTheta});
+      }
+
+      tanHalfAngle = numCones > 6 ? 0.414f : 0.577f;
+    }
+
+    void VoxelAO::build(const Model *model, int resolution)
+    {
+      bounds = model->bounds;
+
+      if (logLevel() >= 1) {
+        int skipped = 0;
+        for (const auto &g : model->geometry)
+          skipped += dynamic_cast<const TriangleMesh*>(g.ptr) == nullptr;
+
+        if (skipped > 0) {
+          std::cout << "ospray: voxel AO ignores " << skipped
+                    << " geometries which aren't triangle meshes (e.g."
+                    << " instances), they cast no occlusion" << std::endl;
+        }
+      }
+
+      const vec3f extent    = bounds.size();
+      const float maxExtent = reduce_max(extent);
+      const float voxelSize = maxExtent / resolution;
+
+      Level level0;
+      level0.voxelSize = voxelSize;
+      level0.dims = vec3i(std::max(int(ceilf(extent.x / voxelSize)), 1),
+                          std::max(int(ceilf(extent.y / voxelSize)), 1),
+                          std::max(int(ceilf(extent.z / voxelSize)), 1));
+      level0.occupancy.assign(size_t(level0.dims.x) * level0.dims.y *
+                              level0.dims.z, 0);
+
+      levels.push_back(std::move(level0));
+
+      // NOTE(jda) - each task voxelizes all triangles into its own z-slab,
+      //             so no two tasks ever write the same voxel
+      const int numSlabs  = std::min(levels[0].dims.z, 64);
+      const int slabDepth = (levels[0].dims.z + numSlabs - 1) / numSlabs;
+
+      tasking::parallel_for(numSlabs, [&](int slab) {
+        const int zBegin = slab * slabDepth;
+        const int zEnd   = std::min(zBegin + slabDepth, levels[0].dims.z);
+        if (zBegin < zEnd)
+          voxelizeSlab(model, zBegin, zEnd);
+      });
+
+      while (reduce_max(levels.back().dims) > 1) {
+        Level next;
+        next.voxelSize = levels.back().voxelSize * 2.f;
+        next.dims      = vec3i((levels.back().dims.x + 1) / 2,
+                               (levels.back().dims.y + 1) / 2,
+                               (levels.back().dims.z + 1) / 2);
+        next.occupancy.assign(size_t(next.dims.x) * next.dims.y *
+                              next.dims.z, 0);
+        levels.push_back(std::move(next));
+        buildLevel(levels.size() - 1);
+      }
+    }
+
+    void VoxelAO::voxelizeSlab(const Model *model, int zBegin, int zEnd)
+    {
+      auto &level = levels[0];
+      const float rcpVoxelSize = 1.f / level.voxelSize;
+
+      // NOTE(jda) - half a voxel of slack, the exact slab test is done on
+      //             the voxel index below; the outer slabs also take the
+      //             (clamped) points on and beyond the bounds
+      const float slabLower = zBegin == 0 ? -inf :
+          bounds.lower.z + (zBegin - 0.5f) * level.voxelSize;
+      const float slabUpper = zEnd == level.dims.z ? inf :
+          bounds.lower.z + (zEnd + 0.5f) * level.voxelSize;
+
+      for (const auto &g : model->geometry) {
+        const auto *mesh = dynamic_cast<const TriangleMesh*>(g.ptr);
+
+        if (mesh == nullptr)
+          continue;
+
+        for (size_t t = 0; t < mesh->numTris; ++t) {
+          const vec3f v0 = triangleVertex(*mesh, t, 0);
+          const vec3f v1 = triangleVertex(*mesh, t, 1);
+          const vec3f v2 = triangleVertex(*mesh, t, 2);
+
+          const float zMin = std::min(v0.z, std::min(v1.z, v2.z));
+          const float zMax = std::max(v0.z, std::max(v1.z, v2.z));
+
+          if (zMax < slabLower || zMin > slabUpper)
+            continue;
+
+          // sample the triangle at half voxel spacing
+          const vec3f e1 = v1 - v0;
+          const vec3f e2 = v2 - v0;
+          const float maxEdge = std::max(length(e1),
+                                std::max(length(e2), length(v2 - v1)));
+          const int   n = std::max(1, int(2.f * maxEdge * rcpVoxelSize) + 1);
+          const float rcpN = 1.f / n;
+
+          for (int i = 0; i <= n; ++i) {
+            // Only sample the part of this row of the triangle inside the
+            // slab, so a large triangle isn't sampled in full by every slab.
+            int jBegin = 0;
+            int jEnd   = n - i;
+
+            if (!sampleRange(v0.z + (i * rcpN) * e1.z, rcpN * e2.z,
+                             slabLower, slabUpper, jBegin, jEnd))
+              continue;
+
+            for (int j = jBegin; j <= jEnd; ++j) {
+              const vec3f P = v0 + (i * rcpN) * e1 + (j * rcpN) * e2;
+              const vec3f gridP = (P - bounds.lower) * rcpVoxelSize;
+
+              const int z = ospcommon::clamp(int(gridP.z), 0, level.dims.z-1);
+
+              if (z < zBegin || z >= zEnd)
+                continue;
+
+              const int x = ospcommon::clamp(int(gridP.x), 0, level.dims.x-1);
+              const int y = ospcommon::clamp(int(gridP.y), 0, level.dims.y-1);
+
+              level.occupancy[voxelIndex(level.dims, x, y, z)] = 255;
+            }
+          }
+        }
+      }
+    }
+
+    void VoxelAO::buildLevel(int l)
+    {
+      const auto &fine = levels[l-1];
+      auto &coarse     = levels[l];
+
+      tasking::parallel_for(coarse.dims.z, [&](int z) {
+        for (int y = 0; y < coarse.dims.y; ++y) {
+          for (int x = 0; x < coarse.dims.x; ++x) {
+            int sum = 0;
+
+            for (int k = 0; k < 8; ++k) {
+              const int fx = 2*x + (k & 1);
+              const int fy = 2*y + ((k >> 1) & 1);
+              const int fz = 2*z + (k >> 2);
+
+              if (fx < fine.dims.x && fy < fine.dims.y && fz < fine.dims.z)
+                sum += fine.occupancy[voxelIndex(fine.dims, fx, fy, fz)];
+            }
+
+            coarse.occupancy[voxelIndex(coarse.dims, x, y, z)] =
+                uint8_t((sum + 4) / 8);
+          }
+        }
+      });
+    }
+
+    float VoxelAO::occlusion(const vec3f &P, const vec3f &N,
+                             float maxDistance) const
+    {
+      vec3f U, V;
+      getBinormals(U, V, N);
+
+      // NOTE(jda) - start one voxel above the surface, which is itself
+      //             voxelized
+      const float voxelSize = levels[0].voxelSize;
+      const vec3f origin    = P + voxelSize * N;
+
+      float sumOcclusion = 0.f;
+      float sumWeights   = 0.f;
+
+      for (const auto &cone : cones) {
+        const vec3f dir = cone.dir.x * U + cone.dir.y * V + cone.dir.z * N;
+        sumOcclusion += cone.weight * traceCone(origin, dir, maxDistance);
+        sumWeights   += cone.weight;
+      }
+
+      return sumOcclusion / sumWeights;
+    }
+
+    float VoxelAO::traceCone(const vec3f &origin, const vec3f &dir,
+                             float maxDistance) const
+    {
+      const float voxelSize = levels[0].voxelSize;
+      const float rcpVoxelSize = 1.f / voxelSize;
+
+      maxDistance = std::min(maxDistance, length(bounds.size()));
+
+      float alpha = 0.f;
+      float dist  = voxelSize;
+
+      while (dist < maxDistance && alpha < 0.99f) {
+        const vec3f P = origin + dist * dir;
+
+        if (P.x < bounds.lower.x || P.y < bounds.lower.y ||
+            P.z < bounds.lower.z || P.x > bounds.upper.x ||
+            P.y > bounds.upper.y || P.z > bounds.upper.z)
+          break;
+
+        const float diameter = std::max(voxelSize,
+                                        2.f * tanHalfAngle * dist);
+        const float level = ospcommon::fast_log(diameter * rcpVoxelSize) *
+                            1.44269504f;
+
+        alpha += (1.f - alpha) * sample(P, level);
+        dist  += 0.5f * diameter;
+      }
+
+      return alpha;
+    }
+
+    float VoxelAO::sample(const vec3f &P, float level) const
+    {
+      const int   maxLevel = int(levels.size()) - 1;
+      const float l = ospcommon::clamp(level, 0.f, float(maxLevel));
+      const int   l0 = std::min(int(l), maxLevel);
+      const int   l1 = std::min(l0 + 1, maxLevel);
+      const float f  = l - l0;
+
+      const float s0 = sample(P, l0);
+      return f > 0.f ? s0 + f * (sample(P, l1) - s0) : s0;
+    }
+
+    float VoxelAO::sample(const vec3f &P, int l) const
+    {
+      const auto &level = levels[l];
+
+      // voxel centers are at integer + 0.5 grid coordinates
+      const vec3f g  = (P - bounds.lower) * (1.f / level.voxelSize) -
+                       vec3f(0.5f);
+      const vec3f gf = vec3f(floorf(g.x), floorf(g.y), floorf(g.z));
+      const vec3i i0 = vec3i(int(gf.x), int(gf.y), int(gf.z));
+      const vec3f t  = g - gf;
+
+      float result = 0.f;
+
+      for (int k = 0; k < 8; ++k) {
+        const int x = i0.x + (k & 1);
+        const int y = i0.y + ((k >> 1) & 1);
+        const int z = i0.z + (k >> 2);
+
+        if (x < 0 || y < 0 || z < 0 ||
+            x >= level.dims.x || y >= level.dims.y || z >= level.dims.z)
+          continue;
+
+        const float w = ((k & 1)        ? t.x : 1.f - t.x) *
+                        (((k >> 1) & 1) ? t.y : 1.f - t.y) *
+                        ((k >> 2)       ? t.z : 1.f - t.z);
+
+        result += w * level.occupancy[voxelIndex(level.dims, x, y, z)];
+      }
+
+      return result * (1.f / 255.f);
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
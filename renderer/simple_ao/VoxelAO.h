@@ -0,0 +1,110 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "common/Model.h"
+// std
+#include <cstdint>
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief approximate AO from a voxelized occupancy grid
+
+        The triangles of all TriangleMesh geometries in the model are
+        voxelized into a grid with 'resolution' voxels along the longest
+        axis of the model bounds, and a mip chain of average occupancy is
+        built on top of it. AO at a hit point is then estimated by marching
+        a few wide cones over the hemisphere, sampling coarser mip levels as
+        the cone widens, so the cost is independent of the scene's BVH.
+
+        Like AOCache, the grid assumes a static model: renderers rebuild it
+        in commit() when the model or the grid parameters change. Only
+        TriangleMesh geometries are voxelized, other geometries (including
+        instances) cast no occlusion. */
+    struct VoxelAO
+    {
+      /*! \brief called from a renderer's commit(), rebuilds the grid if any
+       *         of the arguments changed since the last call */
+      void update(bool enable, const Model *model, int resolution,
+                  int numCones);
+
+      bool enabled() const;
+
+      /*! \brief fraction of occluded directions in the hemisphere around N,
+       *         considering occluders up to 'maxDistance' away */
+      float occlusion(const vec3f &P, const vec3f &N,
+                      float maxDistance) const;
+
+    private:
+
+      void build(const Model *model, int resolution);
+      void buildCones(int numCones);
+
+      void voxelizeSlab(const Model *model, int zBegin, int zEnd);
+      void buildLevel(int level);
+
+      float traceCone(const vec3f &origin, const vec3f &dir,
+                      float maxDistance) const;
+
+      //! occupancy at 'P', trilinear within and linear between mip levels
+      float sample(const vec3f &P, float level) const;
+      float sample(const vec3f &P, int level) const;
+
+      struct Level
+      {
+        vec3i dims {0};
+        float voxelSize {0.f};
+        std::vector<uint8_t> occupancy; //!< 0-255 fraction of voxel filled
+      };
+
+      struct Cone
+      {
+        vec3f dir;    //!< in the (U, V, N) frame of the hit point
+        float weight; //!< cosine to N
+      };
+
+      struct Settings
+      {
+        bool         enable {false};
+        const Model *model {nullptr};
+        int          resolution {0};
+        int          numCones {0};
+      };
+
+      // Data //
+
+      Settings settings;
+
+      box3f bounds;
+      std::vector<Level> levels;
+      std::vector<Cone>  cones;
+
+      float tanHalfAngle {0.577f};
+    };
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline bool VoxelAO::enabled() const
+    {
+      return !levels.empty();
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "../Renderer.h"
+#include "../../math/fast_math.h"
 
 #include <random>
 
@@ -68,9 +69,12 @@ namespace ospray {
       const float r0 = rotate(rn.x, rot_x);
       const float r1 = rotate(rn.y, rot_y);
 
+      float sinPhi, cosPhi;
+      ospcommon::fast_sincos(float((2.f*M_PI)*r0), sinPhi, cosPhi);
+
       const float w = ospcommon::sqrt(1.f-r1);
-      const float x = ospcommon::cos(float((2.f*M_PI)*r0))*w;
-      const float y = ospcommon::sin(float((2.f*M_PI)*r0))*w;
+      const float x = cosPhi*w;
+      const float y = sinPhi*w;
       const float z = ospcommon::sqrt(r1) + epsilon;
       return x*biNorm0 + y*biNorm1 + z*gNormal;
     }
@@ -105,5 +109,131 @@ namespace ospray {
       return ao_ray;
     }
 
+    // Adaptive AO sampling ///////////////////////////////////////////////////
+
+    /*! \brief settings for adaptive per-pixel AO sample counts
+
+        When enabled, AO rays are traced 'batchSize' at a time and sampling
+        stops as soon as the estimate has converged (see aoConverged()), so
+        the renderer's 'aoSamples' becomes an upper bound instead of a fixed
+        count. */
+    struct ao_adaptive
+    {
+      bool  enabled {false};
+      int   batchSize {4};
+      float varianceThreshold {2.5e-3f};
+    };
+
+    /*! \brief read the 'aoAdaptive*' parameters of a renderer */
+    inline ao_adaptive getAOAdaptiveParams(ManagedObject &renderer)
+    {
+      ao_adaptive adaptive;
+      adaptive.enabled   = renderer.getParam1i("aoAdaptive", 0);
+      adaptive.batchSize = std::max(renderer.getParam1i("aoAdaptiveBatch", 4),
+                                    1);
+      adaptive.varianceThreshold =
+          renderer.getParam1f("aoAdaptiveThreshold", 2.5e-3f);
+      return adaptive;
+    }
+
+    /*! \brief true if no more samples are needed for the estimate
+     *         hits/samples: all samples agree, or the variance of the
+     *         (binomial) estimate dropped below 'varianceThreshold' */
+    inline bool aoConverged(int hits, int samples, float varianceThreshold)
+    {
+      if (hits == 0 || hits == samples)
+        return true;
+
+      const float p = float(hits) / samples;
+      return p * (1.f - p) < varianceThreshold * samples;
+    }
+
+    /*! \brief fraction of occluded samples, at most 'maxSamples' of them
+
+        'traceFcn(int n)' must trace n fresh AO samples and return the number
+        of hits. Without adaptive sampling it is called once for all
+        samples, otherwise once per batch until aoConverged(). */
+    template <typename TRACE_FCN>
+    inline float adaptiveOcclusion(const ao_adaptive &adaptive,
+                                   int maxSamples,
+                                   TRACE_FCN &&traceFcn)
+    {
+      if (maxSamples <= 0)
+        return 0.f;
+
+      if (!adaptive.enabled)
+        return float(traceFcn(maxSamples)) / maxSamples;
+
+      int hits    = 0;
+      int samples = 0;
+
+      while (samples < maxSamples) {
+        const int n = std::min(adaptive.batchSize, maxSamples - samples);
+        hits    += traceFcn(n);
+        samples += n;
+
+        if (aoConverged(hits, samples, adaptive.varianceThreshold))
+          break;
+      }
+
+      return float(hits) / samples;
+    }
+
+    /*! \brief trace 'numSamples' AO rays of one hit point as RayN packets
+
+        All rays share (almost) the same origin, so they are traced
+        simd::width at a time through the packet occlusion path
+        'occludedFcn' (signature of Renderer::isOccluded(vmaski, RayN&)).
+        Samples with dot(dir, N) < 0.05 count as hits and aren't traced.
+        Returns the number of hits. */
+    template <typename OCCLUDED_FCN>
+    inline int traceAOPacketBundle(const DifferentialGeometry &dg,
+                                   const ao_context &ctx,
+                                   const vec3f &N,
+                                   float tMax,
+                                   int numSamples,
+                                   OCCLUDED_FCN &&occludedFcn)
+    {
+      int hits = 0;
+
+      for (int first = 0; first < numSamples; first += simd::width) {
+        const int numLanes = std::min(numSamples - first, int(simd::width));
+
+        RayN rays;
+        OSPRAY_ALIGN(64) int laneActive[simd::width] = {0};
+
+        for (int i = 0; i < numLanes; ++i) {
+          const auto ao_ray = calculateAORay(dg, ctx);
+
+          if (dot(ao_ray.dir, N) < 0.05f) {
+            hits++;
+            continue;
+          }
+
+          laneActive[i] = 1;
+
+          rays.org.x[i] = ao_ray.org.x;
+          rays.org.y[i] = ao_ray.org.y;
+          rays.org.z[i] = ao_ray.org.z;
+          rays.dir.x[i] = ao_ray.dir.x;
+          rays.dir.y[i] = ao_ray.dir.y;
+          rays.dir.z[i] = ao_ray.dir.z;
+          rays.t0[i]    = ao_ray.t0;
+          rays.t[i]     = tMax;
+        }
+
+        const auto active = simd::load<simd::vint>(laneActive) != 0;
+
+        if (simd::none(active))
+          continue;
+
+        const auto occluded = occludedFcn(active, rays) & active;
+
+        simd::foreach_active(occluded, [&](int) { hits++; });
+      }
+
+      return hits;
+    }
+
   }// namespace cpp_renderer
 }// namespace ospray
@@ -17,6 +17,8 @@
 #pragma once
 
 #include "../SimdRenderer.h"
+#include "ao_util.h"
+#include "../../math/sampling_simd.h"
 
 namespace ospray {
   namespace cpp_renderer {
@@ -79,11 +81,8 @@ namespace ospray {
       const auto r0 = rotate(rn.x, rot_x);
       const auto r1 = rotate(rn.y, rot_y);
 
-      const auto w = simd::sqrt(1.f-r1);
-      const auto x = simd::cos((2.f*simd::vfloat{M_PI}*r0))*w;
-      const auto y = simd::sin((2.f*simd::vfloat{M_PI}*r0))*w;
-      const auto z = simd::sqrt(r1) + epsilon;
-      return x*biNorm0 + y*biNorm1 + z*gNormal;
+      const auto d = simd::cosineSampleHemisphere(simd::vec2f{r0, r1});
+      return d.x*biNorm0 + d.y*biNorm1 + (d.z + epsilon)*gNormal;
     }
 
     // NOTE(jda) - RandomTEA variant of getRandomDir()
@@ -100,11 +99,8 @@ namespace ospray {
       const auto r0 = rotate(rn.x, rot.x);
       const auto r1 = rotate(rn.y, rot.y);
 
-      const auto w = simd::sqrt(1.f-r1);
-      const auto x = simd::cos((2.f*simd::vfloat{M_PI}*r0))*w;
-      const auto y = simd::sin((2.f*simd::vfloat{M_PI}*r0))*w;
-      const auto z = simd::sqrt(r1) + epsilon;
-      return x*biNorm0 + y*biNorm1 + z*gNormal;
+      const auto d = simd::cosineSampleHemisphere(simd::vec2f{r0, r1});
+      return d.x*biNorm0 + d.y*biNorm1 + (d.z + epsilon)*gNormal;
     }
 
     inline RayN calculateAORay(const DifferentialGeometryN &dg,
@@ -133,6 +129,16 @@ namespace ospray {
       return ao_ray;
     }
 
+    // NOTE(jda) - SIMD variant of aoConverged(), per lane
+    inline simd::vmaski aoConverged(const simd::vfloat &hits,
+                                    const simd::vfloat &samples,
+                                    float varianceThreshold)
+    {
+      const auto p = hits / samples;
+      return (hits == 0.f) | (hits == samples) |
+             (p * (1.f - p) < varianceThreshold * samples);
+    }
+
 
   }// namespace cpp_renderer
 }// namespace ospray
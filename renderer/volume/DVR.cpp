@@ -54,6 +54,28 @@ namespace ospray {
       Ns = getParam1f("ns", getParam1f("Ns", 10.f));
     }
 
+    // Helper functions ///////////////////////////////////////////////////////
+
+    //! headlight Blinn-Phong shading of a volume sample, using the gradient
+    //! as the (two-sided) normal
+    static inline vec3f shadeSample(const vec3f &color,
+                                    const vec3f &gradient,
+                                    const vec3f &dir,
+                                    const vec3f &specular)
+    {
+      const float len2 = dot(gradient, gradient);
+
+      // NOTE(jda) - homogeneous regions have no normal, leave them unshaded
+      if (len2 <= 0.f)
+        return color;
+
+      // With the light at the eye the half vector is the view direction.
+      const float cosNL = ospcommon::abs(dot(gradient, dir)) * rsqrt(len2);
+
+      return color * (0.2f + 0.8f * cosNL) +
+             specular * ospcommon::fast_pow(cosNL, 20.f);
+    }
+
     // DVR definitions ////////////////////////////////////////////////////////
 
     std::string DVRenderer::toString() const
@@ -74,6 +96,9 @@ namespace ospray {
         currentVolume = dynamic_cast<cpp_renderer::Volume*>(volumes[0].ptr);
       }
 
+      if (currentVolume)
+        currentVolume->beginFrame();
+
       return cpp_renderer::Renderer::beginFrame(fb);
     }
 
@@ -100,16 +125,76 @@ namespace ospray {
         const auto offsetStepSize = (volume.samplingStep / volume.samplingRate);
         ray.t0 += distribution(rng) * offsetStepSize;
 
+        // Pre-integration composites the segment from the previous sample to
+        // the current one, looked up by the values at both ends.
+        bool  havePrevious {false};
+        float previousSample {0.f};
+        float previousT {0.f};
+        float previousStep {0.f};
+
         ///////////////////////////////////////////////////////////////////////
         // NOTE(jda) - this section needs to be a function/object!
         while (ray.t0 < ray.t) {
-          auto samplePoint  = ray.org + ray.t0 * ray.dir;
-          auto volumeSample = volume.computeSample(samplePoint);
-
-          auto sampleColor   = tFcn.color(volumeSample);
-          auto sampleOpacity = tFcn.opacity(volumeSample);
-
-          auto clampedOpacity = clamp(sampleOpacity / volume.samplingRate);
+          auto samplePoint = ray.org + ray.t0 * ray.dir;
+
+          vec3f gradient;
+          auto volumeSample = volume.gradientShadingEnabled ?
+              volume.computeSampleAndGradient(samplePoint, gradient) :
+              volume.computeSample(samplePoint);
+
+          // NOTE(jda) - opacity correction must use the length of the step
+          //             actually taken after this sample: a backtrack into a
+          //             finer cell shortens it, while empty space skipped
+          //             beyond the regular step is not part of it
+          const float tSample  = ray.t0;
+          const float cellRate = volume.adaptiveSamplingEnabled ?
+                                 volume.adaptiveSamplingRate(samplePoint) :
+                                 volume.samplingRate;
+
+          if (volume.adaptiveSamplingEnabled)
+            currentVolume->advanceAdaptive(ray);
+          else
+            currentVolume->advance(ray);
+
+          const float regularStep = volume.samplingStep / cellRate;
+          const float stepLength  = ospcommon::min(ray.t0 - tSample,
+                                                   regularStep);
+
+          auto samplingRate = volume.samplingStep / stepLength;
+
+          vec3f sampleColor;
+          float sampleOpacity;
+
+          if (volume.preIntegrationEnabled) {
+            // NOTE(jda) - a segment across skipped empty space would blend
+            //             values that were never sampled, start over instead
+            const bool contiguous = havePrevious &&
+                                    tSample - previousT <= 1.01f *
+                                                           previousStep;
+
+            const float front = contiguous ? previousSample : volumeSample;
+
+            sampleColor   = tFcn.integratedColor(front, volumeSample);
+            sampleOpacity = tFcn.integratedOpacity(front, volumeSample);
+
+            if (contiguous)
+              samplingRate = volume.samplingStep / (tSample - previousT);
+
+            havePrevious   = true;
+            previousSample = volumeSample;
+            previousT      = tSample;
+            previousStep   = stepLength;
+          } else {
+            sampleColor   = tFcn.color(volumeSample);
+            sampleOpacity = tFcn.opacity(volumeSample);
+          }
+
+          if (volume.gradientShadingEnabled && sampleOpacity > 0.f) {
+            sampleColor = shadeSample(sampleColor, gradient, ray.dir,
+                                      volume.specular);
+          }
+
+          auto clampedOpacity = clamp(sampleOpacity / samplingRate);
           sampleColor *= clampedOpacity;
 
           color   += (1.f - opacity) * sampleColor;
@@ -117,8 +202,6 @@ namespace ospray {
 
           if (opacity >= 0.99f)
             break;
-
-          currentVolume->advance(ray);
         }
         ///////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,79 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "Isosurface.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // IsosurfaceRenderer definitions /////////////////////////////////////////
+
+    std::string IsosurfaceRenderer::toString() const
+    {
+      return "ospray::cpp_renderer::IsosurfaceRenderer";
+    }
+
+    void *IsosurfaceRenderer::beginFrame(FrameBuffer *fb)
+    {
+      auto &volumes = model->volume;
+
+      currentVolume = nullptr;
+
+      if (!volumes.empty()) {
+        currentVolume = dynamic_cast<cpp_renderer::Volume*>(volumes[0].ptr);
+      }
+
+      return cpp_renderer::Renderer::beginFrame(fb);
+    }
+
+    void IsosurfaceRenderer::renderSample(void *perFrameData,
+                                          ScreenSample &sample) const
+    {
+      UNUSED(perFrameData);
+
+      sample.rgb = bgColor;
+
+      if (currentVolume == nullptr)
+        return;
+
+      auto &ray = sample.ray;
+      const auto &volume = *currentVolume;
+
+      volume.intersectIsosurface(volume.isovalues, ray);
+
+      if (ray.hitSomething()) {
+        const float isovalue = volume.isovalues[ray.primID];
+        const vec3f color    = volume.transferFunction->color(isovalue);
+
+        // NOTE(jda) - gradients vanish on flat regions of the volume
+        const vec3f Ng   = ray.Ng;
+        const vec3f dir  = ray.dir;
+        const float len2 = dot(Ng, Ng);
+        const float c    = len2 > 0.f ?
+            0.2f + 0.8f * ospcommon::abs(dot(Ng, dir)) * rsqrt(len2) :
+            1.f;
+
+        sample.rgb   = c * color;
+        sample.z     = ray.t;
+        sample.alpha = 1.f;
+      }
+    }
+
+    OSP_REGISTER_RENDERER(IsosurfaceRenderer, cpp_isosurface);
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,149 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "SimdDVR.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // Material definition ////////////////////////////////////////////////////
+
+    struct SimdDVMaterial : public ospray::Material
+    {
+      void commit() override;
+
+      float d;
+      vec3f Kd;
+      vec3f Ks;
+      float Ns;
+
+      Ref<Texture2D> map_d;
+      Ref<Texture2D> map_Kd;
+      Ref<Texture2D> map_Ks;
+      Ref<Texture2D> map_Ns;
+    };
+
+    void SimdDVMaterial::commit()
+    {
+      map_d  = (Texture2D*)getParamObject("map_d", nullptr);
+      map_Kd = (Texture2D*)getParamObject("map_Kd",
+                                          getParamObject("map_kd", nullptr));
+      map_Ks = (Texture2D*)getParamObject("map_Ks",
+                                          getParamObject("map_ks", nullptr));
+      map_Ns = (Texture2D*)getParamObject("map_Ns",
+                                          getParamObject("map_ns", nullptr));
+
+      d  = getParam1f("d", 1.f);
+      Kd = getParam3f("kd", getParam3f("Kd", vec3f(.8f)));
+      Ks = getParam3f("ks", getParam3f("Ks", vec3f(0.f)));
+      Ns = getParam1f("ns", getParam1f("Ns", 10.f));
+    }
+
+    // SimdDVR definitions ////////////////////////////////////////////////////
+
+    std::string SimdDVRenderer::toString() const
+    {
+      return "ospray::cpp_renderer::SimdDVRenderer";
+    }
+
+    void SimdDVRenderer::commit()
+    {
+      cpp_renderer::SimdRenderer::commit();
+    }
+
+    void *SimdDVRenderer::beginFrame(FrameBuffer *fb)
+    {
+      auto &volumes = model->volume;
+
+      if (!volumes.empty()) {
+        currentVolume = dynamic_cast<cpp_renderer::Volume*>(volumes[0].ptr);
+      }
+
+      if (currentVolume)
+        currentVolume->beginFrame();
+
+      return cpp_renderer::SimdRenderer::beginFrame(fb);
+    }
+
+    void SimdDVRenderer::renderSample(simd::vmaski active,
+                                      void *perFrameData,
+                                      ScreenSampleN &sample) const
+    {
+      UNUSED(perFrameData);
+
+      sample.rgb = simd::vec3f{bgColor};
+
+      if (currentVolume == nullptr)
+        return;
+
+      auto &ray      = sample.ray;
+      auto hitVolume = currentVolume->intersectN(active, ray);
+
+      if (simd::none(hitVolume))
+        return;
+
+      simd::vec3f  color {simd::vfloat{0.f}};
+      simd::vfloat opacity {0.f};
+      const auto &volume = *currentVolume;
+      const auto &tFcn   = *volume.transferFunction;
+
+      const auto offsetStepSize = (volume.samplingStep / volume.samplingRate);
+      ray.t0 = simd::select(hitVolume,
+                            ray.t0 + simd::randUniformDist() * offsetStepSize,
+                            ray.t0);
+
+      // Lanes retire individually once they leave the volume or saturate, the
+      // whole packet retires once no lane is left marching.
+      auto marching = hitVolume & (ray.t0 < ray.t);
+
+      while (simd::any(marching)) {
+        auto samplePoint  = ray.org + ray.t0 * ray.dir;
+        auto volumeSample = volume.computeSampleN(marching, samplePoint);
+
+        auto sampleColor   = tFcn.colorN(marching, volumeSample);
+        auto sampleOpacity = tFcn.opacityN(marching, volumeSample);
+
+        auto clampedOpacity =
+            simd::min(simd::max(sampleOpacity / volume.samplingRate, 0.f), 1.f);
+        clampedOpacity = simd::select(marching, clampedOpacity, 0.f);
+        sampleColor *= clampedOpacity;
+
+        const auto transmission = 1.f - opacity;
+        color   += transmission * sampleColor;
+        opacity += transmission * clampedOpacity;
+
+        marching = marching & (opacity < 0.99f);
+
+        currentVolume->advanceN(marching, ray);
+
+        marching = marching & (ray.t0 < ray.t);
+      }
+
+      sample.rgb = simd::select(hitVolume,
+                                sample.rgb * (1.f - opacity) + opacity * color,
+                                sample.rgb);
+    }
+
+    Material *SimdDVRenderer::createMaterial(const char *type)
+    {
+      UNUSED(type);
+      return new SimdDVMaterial;
+    }
+
+    OSP_REGISTER_RENDERER(SimdDVRenderer, cpp_dvr_simd);
+
+  }// namespace cpp_renderer
+}// namespace ospray
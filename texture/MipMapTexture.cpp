@@ -0,0 +1,412 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "MipMapTexture.h"
+// ospray
+#include "ospcommon/tasking/parallel_for.h"
+// std
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    // Helper functions ///////////////////////////////////////////////////////
+
+    // NOTE(jda) - exact conversions (not fast_pow), they only run at load
+    //             time and 8 bit sRGB values have to survive a round trip
+
+    static inline float srgbToLinear(float c)
+    {
+      return c <= 0.04045f ? c / 12.92f :
+                             std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static inline float linearToSrgb(float c)
+    {
+      return c <= 0.0031308f ? c * 12.92f :
+                               1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+    }
+
+    static inline uint32 toByte(float c)
+    {
+      return uint32(ospcommon::clamp(c, 0.f, 1.f) * 255.f + .5f);
+    }
+
+    static inline bool isSupported(OSPTextureFormat type)
+    {
+      switch (type) {
+      case OSP_TEXTURE_RGBA8:
+      case OSP_TEXTURE_SRGBA:
+      case OSP_TEXTURE_RGBA32F:
+      case OSP_TEXTURE_RGB8:
+      case OSP_TEXTURE_SRGB:
+      case OSP_TEXTURE_RGB32F:
+      case OSP_TEXTURE_R8:
+      case OSP_TEXTURE_R32F:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    // MipMapTexture definitions //////////////////////////////////////////////
+
+    std::shared_ptr<const MipMapTexture>
+    MipMapTexture::get(const Texture2D *tex)
+    {
+      if (tex == nullptr || tex->data == nullptr ||
+          tex->size.x <= 0 || tex->size.y <= 0 || !isSupported(tex->type)) {
+        return nullptr;
+      }
+
+      // NOTE(jda) - materials referencing the same texture (common with
+      //             OBJ files) share one mip chain; entries are dropped
+      //             once no material uses them anymore
+      using Key = std::tuple<const Texture2D*, const void*, int, int, int>;
+
+      static std::mutex mutex;
+      static std::map<Key, std::weak_ptr<const MipMapTexture>> cache;
+
+      const Key key {tex, tex->data, tex->size.x, tex->size.y, tex->type};
+
+      std::lock_guard<std::mutex> lock(mutex);
+
+      for (auto it = cache.begin(); it != cache.end();) {
+        if (it->second.expired())
+          it = cache.erase(it);
+        else
+          ++it;
+      }
+
+      auto cached = cache[key].lock();
+
+      if (!cached) {
+        cached = std::make_shared<const MipMapTexture>(tex);
+        cache[key] = cached;
+      }
+
+      return cached;
+    }
+
+    MipMapTexture::MipMapTexture(const Texture2D *tex)
+    {
+      nearest = tex->flags & OSP_TEXTURE_FILTER_NEAREST;
+      hdr     = tex->type == OSP_TEXTURE_RGBA32F ||
+                tex->type == OSP_TEXTURE_RGB32F  ||
+                tex->type == OSP_TEXTURE_R32F;
+      srgb    = tex->type == OSP_TEXTURE_SRGBA ||
+                tex->type == OSP_TEXTURE_SRGB;
+
+      for (int i = 0; i < 256; ++i) {
+        const float c = i * (1.f / 255.f);
+        decode[i] = srgb ? srgbToLinear(c) : c;
+      }
+
+      load(tex);
+
+      if (!nearest)
+        buildLevels();
+    }
+
+    void MipMapTexture::load(const Texture2D *tex)
+    {
+      const int width  = tex->size.x;
+      const int height = tex->size.y;
+
+      std::vector<vec4f> linear(size_t(width) * height);
+
+      tasking::parallel_for(height, [&](int y) {
+        for (int x = 0; x < width; ++x) {
+          const size_t i = size_t(y) * width + x;
+
+          const auto *u8  = static_cast<const uint8*>(tex->data);
+          const auto *f32 = static_cast<const float*>(tex->data);
+
+          vec4f c;
+
+          switch (tex->type) {
+          case OSP_TEXTURE_RGBA8:
+          case OSP_TEXTURE_SRGBA:
+            c = vec4f(decode[u8[4*i+0]], decode[u8[4*i+1]],
+                      decode[u8[4*i+2]], u8[4*i+3] * (1.f / 255.f));
+            break;
+          case OSP_TEXTURE_RGB8:
+          case OSP_TEXTURE_SRGB:
+            c = vec4f(decode[u8[3*i+0]], decode[u8[3*i+1]],
+                      decode[u8[3*i+2]], 1.f);
+            break;
+          case OSP_TEXTURE_R8:
+            c = vec4f(decode[u8[i]], decode[u8[i]], decode[u8[i]], 1.f);
+            break;
+          case OSP_TEXTURE_RGBA32F:
+            c = vec4f(f32[4*i+0], f32[4*i+1], f32[4*i+2], f32[4*i+3]);
+            break;
+          case OSP_TEXTURE_RGB32F:
+            c = vec4f(f32[3*i+0], f32[3*i+1], f32[3*i+2], 1.f);
+            break;
+          default: // OSP_TEXTURE_R32F
+            c = vec4f(f32[i], f32[i], f32[i], 1.f);
+            break;
+          }
+
+          linear[i] = c;
+        }
+      });
+
+      levelWidth.push_back(width);
+      levelHeight.push_back(height);
+
+      store(0, linear);
+    }
+
+    void MipMapTexture::buildLevels()
+    {
+      // NOTE(jda) - each level is box filtered from the previous one in
+      //             linear space; odd sizes clamp the last row/column
+      int level = 0;
+
+      while (levelWidth[level] > 1 || levelHeight[level] > 1) {
+        const int w  = levelWidth[level];
+        const int h  = levelHeight[level];
+        const int nw = std::max(w / 2, 1);
+        const int nh = std::max(h / 2, 1);
+
+        std::vector<vec4f> linear(size_t(nw) * nh);
+
+        tasking::parallel_for(nh, [&](int y) {
+          const int y0 = std::min(2*y,     h - 1);
+          const int y1 = std::min(2*y + 1, h - 1);
+
+          for (int x = 0; x < nw; ++x) {
+            const int x0 = std::min(2*x,     w - 1);
+            const int x1 = std::min(2*x + 1, w - 1);
+
+            linear[size_t(y) * nw + x] = .25f * (texel(level, x0, y0) +
+                                                 texel(level, x1, y0) +
+                                                 texel(level, x0, y1) +
+                                                 texel(level, x1, y1));
+          }
+        });
+
+        levelWidth.push_back(nw);
+        levelHeight.push_back(nh);
+
+        store(++level, linear);
+      }
+    }
+
+    void MipMapTexture::store(int level, const std::vector<vec4f> &linear)
+    {
+      const int w      = levelWidth[level];
+      const int h      = levelHeight[level];
+      const int tilesX = (w + 3) / 4;
+      const int tilesY = (h + 3) / 4;
+      const int offset = hdr ? int(texels32f.size()) : int(texels8.size());
+
+      levelTilesX.push_back(tilesX);
+      levelOffset.push_back(offset);
+
+      const size_t numTexels = size_t(tilesX) * tilesY * 16;
+
+      if (hdr)
+        texels32f.resize(offset + numTexels, vec4f(0.f));
+      else
+        texels8.resize(offset + numTexels, 0);
+
+      tasking::parallel_for(h, [&](int y) {
+        for (int x = 0; x < w; ++x) {
+          const vec4f &c = linear[size_t(y) * w + x];
+          const int    i = texelIndex(level, x, y);
+
+          if (hdr) {
+            texels32f[i] = c;
+          } else {
+            const vec3f rgb = srgb ? vec3f(linearToSrgb(c.x),
+                                           linearToSrgb(c.y),
+                                           linearToSrgb(c.z)) :
+                                     vec3f(c.x, c.y, c.z);
+            texels8[i] = toByte(rgb.x) | (toByte(rgb.y) << 8) |
+                         (toByte(rgb.z) << 16) | (toByte(c.w) << 24);
+          }
+        }
+      });
+    }
+
+    vec4f MipMapTexture::bilinear(int level, const vec2f &st) const
+    {
+      const int w = levelWidth[level];
+      const int h = levelHeight[level];
+
+      // texel centers are at integer + 0.5 coordinates
+      const float x  = (st.x - floorf(st.x)) * w - .5f;
+      const float y  = (st.y - floorf(st.y)) * h - .5f;
+      const float fx = floorf(x);
+      const float fy = floorf(y);
+      const float tx = x - fx;
+      const float ty = y - fy;
+
+      // NOTE(jda) - coordinates are wrapped into [0,1) first, so only the
+      //             -1 and w (h) neighbors need to wrap around
+      int x0 = int(fx), x1 = x0 + 1;
+      int y0 = int(fy), y1 = y0 + 1;
+
+      if (x0 < 0)  x0 = w - 1;
+      if (x1 >= w) x1 = 0;
+      if (y0 < 0)  y0 = h - 1;
+      if (y1 >= h) y1 = 0;
+
+      return (1.f - ty) * ((1.f - tx) * texel(level, x0, y0) +
+                           tx * texel(level, x1, y0)) +
+             ty * ((1.f - tx) * texel(level, x0, y1) +
+                   tx * texel(level, x1, y1));
+    }
+
+    vec4f MipMapTexture::sample(const vec2f &st, float width) const
+    {
+      if (nearest) {
+        const int w = levelWidth[0];
+        const int h = levelHeight[0];
+        const int x = std::min(int((st.x - floorf(st.x)) * w), w - 1);
+        const int y = std::min(int((st.y - floorf(st.y)) * h), h - 1);
+        return texel(0, x, y);
+      }
+
+      const int   maxLevel = numLevels() - 1;
+      const float l  = std::min(lod(width), float(maxLevel));
+      const int   l0 = int(l);
+      const float f  = l - l0;
+
+      const vec4f c0 = bilinear(l0, st);
+      return f > 0.f ? c0 + f * (bilinear(std::min(l0 + 1, maxLevel), st) - c0)
+                     : c0;
+    }
+
+    simd::vec4f MipMapTexture::bilinear(simd::vmaski active,
+                                        const simd::vint &level,
+                                        const simd::vec2f &st) const
+    {
+      using simd::vfloat;
+      using simd::vint;
+
+      const vint w      = vint::gather(active, levelWidth.data(),  level);
+      const vint h      = vint::gather(active, levelHeight.data(), level);
+      const vint tilesX = vint::gather(active, levelTilesX.data(), level);
+      const vint offset = vint::gather(active, levelOffset.data(), level);
+
+      const vfloat x = (st.x - simd::floor(st.x)) * simd::cast<vfloat>(w) - .5f;
+      const vfloat y = (st.y - simd::floor(st.y)) * simd::cast<vfloat>(h) - .5f;
+
+      vint x0 = simd::floori(x);
+      vint y0 = simd::floori(y);
+
+      const vfloat tx = x - simd::cast<vfloat>(x0);
+      const vfloat ty = y - simd::cast<vfloat>(y0);
+
+      vint x1 = x0 + 1;
+      vint y1 = y0 + 1;
+
+      x0 = simd::select(x0 < vint(0), w - 1,   x0);
+      x1 = simd::select(x1 >= w,      vint(0), x1);
+      y0 = simd::select(y0 < vint(0), h - 1,   y0);
+      y1 = simd::select(y1 >= h,      vint(0), y1);
+
+      auto index = [&](const vint &xi, const vint &yi) {
+        return offset + (((yi >> 2) * tilesX + (xi >> 2)) << 4) +
+               ((yi & vint(3)) << 2) + (xi & vint(3));
+      };
+
+      auto fetch = [&](const vint &i) -> simd::vec4f {
+        if (hdr) {
+          const float *f = reinterpret_cast<const float*>(texels32f.data());
+          const vint   o = i << 2;
+          return {vfloat::gather(active, f + 0, o),
+                  vfloat::gather(active, f + 1, o),
+                  vfloat::gather(active, f + 2, o),
+                  vfloat::gather(active, f + 3, o)};
+        }
+
+        const vint rgba =
+            vint::gather(active, reinterpret_cast<const int*>(texels8.data()),
+                         i);
+
+        // NOTE(jda) - the arithmetic shift sign-extends alpha, masked away
+        return {vfloat::gather(active, decode.data(), rgba & vint(0xff)),
+                vfloat::gather(active, decode.data(),
+                               (rgba >> 8) & vint(0xff)),
+                vfloat::gather(active, decode.data(),
+                               (rgba >> 16) & vint(0xff)),
+                simd::cast<vfloat>((rgba >> 24) & vint(0xff)) *
+                    (1.f / 255.f)};
+      };
+
+      const simd::vec4f c00 = fetch(index(x0, y0));
+      const simd::vec4f c10 = fetch(index(x1, y0));
+      const simd::vec4f c01 = fetch(index(x0, y1));
+      const simd::vec4f c11 = fetch(index(x1, y1));
+
+      return (1.f - ty) * ((1.f - tx) * c00 + tx * c10) +
+             ty * ((1.f - tx) * c01 + tx * c11);
+    }
+
+    simd::vec4f MipMapTexture::sample(simd::vmaski active,
+                                      const simd::vec2f &st,
+                                      const simd::vfloat &width) const
+    {
+      using simd::vfloat;
+      using simd::vint;
+
+      if (nearest) {
+        simd::vec4f result;
+        simd::foreach_active(active, [&](int i) {
+          const vec4f c = sample(vec2f(st.x[i], st.y[i]), 0.f);
+          result.x[i] = c.x;
+          result.y[i] = c.y;
+          result.z[i] = c.z;
+          result.w[i] = c.w;
+        });
+        return result;
+      }
+
+      const float  maxLevel = float(numLevels() - 1);
+      const vfloat texels   = width * float(std::max(levelWidth[0],
+                                                     levelHeight[0]));
+
+      // log2(texels), for footprints wider than a texel
+      vfloat l = simd::select(texels > 1.f,
+                              simd::log(simd::max(texels, 1.f)) * 1.44269504f,
+                              vfloat(0.f));
+      l = simd::min(l, maxLevel);
+
+      const vint   l0 = simd::floori(l);
+      const vint   l1 = simd::min(l0 + 1, vint(numLevels() - 1));
+      const vfloat f  = l - simd::cast<vfloat>(l0);
+
+      const simd::vec4f c0 = bilinear(active, l0, st);
+
+      const auto trilinear = active & (f > 0.f);
+
+      if (simd::none(trilinear))
+        return c0;
+
+      const simd::vec4f c1 = bilinear(trilinear, l1, st);
+      return simd::select(trilinear, c0 + f * (c1 - c0), c0);
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
@@ -0,0 +1,175 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospray
+#include "texture/Texture2D.h"
+// ospray_cpp
+#include "../common/simd.h"
+// std
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief mip-mapped copy of an ospray::Texture2D for the C++ renderers
+
+        Texels of every mip level are stored in 4x4 tiles (64 bytes, one
+        cache line, for 8 bit formats), so a bilinear footprint almost always
+        touches a single line even for the incoherent hits of secondary
+        rays. 8 bit textures keep their encoding and are decoded with a table
+        per fetch, float textures are stored as RGBA32F. The mip chain is
+        built (box filtered, in linear space) when the texture is converted.
+
+        Texture coordinates wrap (repeat). The level of detail comes from
+        the width of the ray footprint in texture space (see
+        DifferentialGeometry::stWidth): lookups are trilinear, or nearest on
+        level 0 with OSP_TEXTURE_FILTER_NEAREST. */
+    struct MipMapTexture
+    {
+      /*! \brief converted copy of 'tex', shared by everything using the same
+       *         texture; nullptr for a null or unsupported texture */
+      static std::shared_ptr<const MipMapTexture> get(const Texture2D *tex);
+
+      explicit MipMapTexture(const Texture2D *tex);
+
+      vec2i size() const;
+      int   numLevels() const;
+
+      /*! \brief level of detail for a footprint 'width' wide in texture
+       *         coordinates */
+      float lod(float width) const;
+
+      vec4f sample(const vec2f &st, float width) const;
+
+      simd::vec4f sample(simd::vmaski active,
+                         const simd::vec2f &st,
+                         const simd::vfloat &width) const;
+
+    private:
+
+      void load(const Texture2D *tex);
+      void buildLevels();
+
+      int   texelIndex(int level, int x, int y) const;
+      vec4f texel(int level, int x, int y) const;
+      vec4f bilinear(int level, const vec2f &st) const;
+
+      simd::vec4f bilinear(simd::vmaski active,
+                           const simd::vint &level,
+                           const simd::vec2f &st) const;
+
+      //! \brief level 'level' (not yet stored) from texels in linear space
+      void store(int level, const std::vector<vec4f> &linear);
+
+      // Data //
+
+      bool hdr {false};     //!< RGBA32F storage, otherwise RGBA8
+      bool srgb {false};    //!< 8 bit color channels are sRGB encoded
+      bool nearest {false};
+
+      // per level, SoA for gathers
+      std::vector<int> levelWidth;
+      std::vector<int> levelHeight;
+      std::vector<int> levelTilesX;
+      std::vector<int> levelOffset; //!< of the first texel in 'texels*'
+
+      std::vector<uint32> texels8;
+      std::vector<vec4f>  texels32f;
+
+      //! 8 bit channel value to linear float
+      std::array<float, 256> decode;
+    };
+
+    // Texture lookup helpers /////////////////////////////////////////////////
+
+    /*! \brief lookups returning 'defaultValue' without a texture, like the
+     *         get*f() functions of OSPRay's ISPC Texture2D */
+    inline vec4f get4f(const MipMapTexture *tex,
+                       const vec2f &st,
+                       float width,
+                       const vec4f &defaultValue)
+    {
+      return tex ? tex->sample(st, width) : defaultValue;
+    }
+
+    inline vec3f get3f(const MipMapTexture *tex,
+                       const vec2f &st,
+                       float width,
+                       const vec3f &defaultValue)
+    {
+      if (!tex)
+        return defaultValue;
+
+      const vec4f v = tex->sample(st, width);
+      return vec3f(v.x, v.y, v.z);
+    }
+
+    inline float get1f(const MipMapTexture *tex,
+                       const vec2f &st,
+                       float width,
+                       float defaultValue)
+    {
+      return tex ? tex->sample(st, width).x : defaultValue;
+    }
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline vec2i MipMapTexture::size() const
+    {
+      return vec2i(levelWidth[0], levelHeight[0]);
+    }
+
+    inline int MipMapTexture::numLevels() const
+    {
+      return static_cast<int>(levelWidth.size());
+    }
+
+    inline float MipMapTexture::lod(float width) const
+    {
+      const float texels = width * std::max(levelWidth[0], levelHeight[0]);
+      return texels > 1.f ? std::log2(texels) : 0.f;
+    }
+
+    inline int MipMapTexture::texelIndex(int level, int x, int y) const
+    {
+      // NOTE(jda) - 4x4 tiles, row major within and between tiles
+      return levelOffset[level] +
+             ((y >> 2) * levelTilesX[level] + (x >> 2)) * 16 +
+             ((y & 3) << 2) + (x & 3);
+    }
+
+    inline vec4f MipMapTexture::texel(int level, int x, int y) const
+    {
+      const int i = texelIndex(level, x, y);
+
+      if (hdr)
+        return texels32f[i];
+
+      const uint32 rgba = texels8[i];
+      return vec4f(decode[ rgba        & 0xff],
+                   decode[(rgba >>  8) & 0xff],
+                   decode[(rgba >> 16) & 0xff],
+                   (rgba >> 24) * (1.f / 255.f));
+    }
+
+  }// namespace cpp_renderer
+}// namespace ospray
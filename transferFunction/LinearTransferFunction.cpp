@@ -16,11 +16,14 @@
 
 #include "common/Data.h"
 #include "common/OSPCommon.h"
+#include "ospcommon/tasking/parallel_for.h"
 #include "LinearTransferFunction.h"
 
 namespace ospray {
   namespace cpp_renderer {
 
+    constexpr int LinearTransferFunction::PREINTEGRATION_TABLE_SIZE;
+
     void LinearTransferFunction::commit()
     {
       // Retrieve the color and opacity values.
@@ -40,9 +43,13 @@ namespace ospray {
         memcpy(opacityValues.data(), opacityData->data, opacityData->numBytes);
       }
 
-      preIntegrationEnabled = getParam1i("preIntegration", 0);
-
       TransferFunction::commit();
+
+      buildOpacityRangeTable();
+
+      // NOTE(jda) - rebuilt by preparePreIntegration() when a volume with
+      //             "preIntegration" set begins a frame
+      preIntegrationTable.clear();
     }
 
     std::string LinearTransferFunction::toString() const
@@ -83,7 +90,12 @@ namespace ospray {
     vec3f LinearTransferFunction::integratedColor(float value1,
                                                   float value2) const
     {
-      NOT_IMPLEMENTED
+      // NOTE(jda) - without a table, fall back to the segment's midpoint
+      if (preIntegrationTable.empty())
+        return color(0.5f * (value1 + value2));
+
+      const vec4f result = integrated(value1, value2);
+      return vec3f{result.x, result.y, result.z};
     }
 
     float LinearTransferFunction::opacity(float value) const
@@ -119,17 +131,279 @@ namespace ospray {
     float LinearTransferFunction::integratedOpacity(float value1,
                                                     float value2) const
     {
-      NOT_IMPLEMENTED
+      if (preIntegrationTable.empty())
+        return opacity(0.5f * (value1 + value2));
+
+      return integrated(value1, value2).w;
     }
 
     float LinearTransferFunction::maxOpacity(const vec2f &range) const
     {
-      NOT_IMPLEMENTED
+      return minMaxOpacity(range).y;
     }
 
     vec2f LinearTransferFunction::minMaxOpacity(const vec2f &range) const
     {
-      NOT_IMPLEMENTED
+      if (opacityValues.empty())
+        return vec2f{1.0f};
+
+      const int numOpacities = static_cast<int>(opacityValues.size());
+
+      // Map the range into [0.0, numValues - 1], like opacity() does.
+      auto remap = [&](float value) {
+        return ospcommon::clamp((value - valueRange.x)
+                                / (valueRange.y - valueRange.x)
+                                * (numOpacities - 1.0f),
+                                0.0f, numOpacities - 1.0f);
+      };
+
+      const float lower = remap(range.x);
+      const float upper = remap(range.y);
+
+      // The opacity is piecewise linear, so its extrema over the range are
+      // at the range's end points or at control points inside the range.
+      const float opacityLower = opacity(range.x);
+      const float opacityUpper = opacity(range.y);
+
+      vec2f result {ospcommon::min(opacityLower, opacityUpper),
+                    ospcommon::max(opacityLower, opacityUpper)};
+
+      const int first = int(std::ceil(lower));
+      const int last  = int(upper);
+
+      if (first <= last) {
+        const vec2f inner = controlPointMinMax(first, last);
+        result.x = ospcommon::min(result.x, inner.x);
+        result.y = ospcommon::max(result.y, inner.y);
+      }
+
+      return result;
+    }
+
+    void LinearTransferFunction::maxOpacities(const vec2f *ranges,
+                                              float *results,
+                                              size_t count) const
+    {
+      // NOTE(jda) - no virtual call per range, the batch is a tight loop
+      for (size_t i = 0; i < count; ++i)
+        results[i] = LinearTransferFunction::minMaxOpacity(ranges[i]).y;
+    }
+
+    vec2f LinearTransferFunction::controlPointMinMax(int first,
+                                                     int last) const
+    {
+      const int   level = opacityRangeLevel[last - first + 1];
+      const auto &table = opacityRangeTable[level];
+      const vec2f &a = table[first];
+      const vec2f &b = table[last - (1 << level) + 1];
+      return vec2f{ospcommon::min(a.x, b.x), ospcommon::max(a.y, b.y)};
+    }
+
+    void LinearTransferFunction::buildOpacityRangeTable()
+    {
+      const int numOpacities = static_cast<int>(opacityValues.size());
+
+      opacityRangeTable.clear();
+      opacityRangeLevel.assign(numOpacities + 1, 0);
+
+      if (numOpacities == 0)
+        return;
+
+      for (int n = 2; n <= numOpacities; ++n)
+        opacityRangeLevel[n] = opacityRangeLevel[n / 2] + 1;
+
+      std::vector<vec2f> level0(numOpacities);
+      for (int i = 0; i < numOpacities; ++i)
+        level0[i] = vec2f{opacityValues[i]};
+
+      opacityRangeTable.push_back(std::move(level0));
+
+      for (int width = 2; width <= numOpacities; width *= 2) {
+        const auto &previous = opacityRangeTable.back();
+        const int half = width / 2;
+
+        std::vector<vec2f> level(numOpacities - width + 1);
+        for (size_t i = 0; i < level.size(); ++i) {
+          const vec2f &a = previous[i];
+          const vec2f &b = previous[i + half];
+          level[i] = vec2f{ospcommon::min(a.x, b.x),
+                           ospcommon::max(a.y, b.y)};
+        }
+
+        opacityRangeTable.push_back(std::move(level));
+      }
+    }
+
+    simd::vec3f LinearTransferFunction::colorN(simd::vmaskf active,
+                                               const simd::vfloat &value) const
+    {
+      if (colorValues.empty())
+        return simd::make_vec3f(1.f, 1.f, 1.f);
+
+      const int numColors = static_cast<int>(colorValues.size());
+
+      // NaN values compare false with themselves and return black
+      const auto valid = active & (value == value);
+
+      // Map the value into the range [0.0, numColors - 1], which also covers
+      // values outside of the value range.
+      auto remapped = (value - valueRange.x)
+                      / (valueRange.y - valueRange.x)
+                      * (numColors - 1.0f);
+      remapped = simd::min(simd::max(remapped, 0.f), numColors - 1.0f);
+
+      // Compute the color indices and fractional offset.
+      const simd::vint index0    = simd::floori(remapped);
+      const simd::vint index1    = simd::min(index0 + 1, numColors - 1);
+      const simd::vfloat remainder = remapped - simd::cast<simd::vfloat>(index0);
+
+      // Gather the interpolated colors, one component at a time
+      const float *colors = reinterpret_cast<const float*>(colorValues.data());
+      const simd::vint offset0 = index0 * 3;
+      const simd::vint offset1 = index1 * 3;
+
+      auto lerpComponent = [&](int c) {
+        const auto c0 = simd::vfloat::gather(valid, colors + c, offset0);
+        const auto c1 = simd::vfloat::gather(valid, colors + c, offset1);
+        return simd::select(valid,
+                            (1.0f - remainder) * c0 + remainder * c1,
+                            simd::vfloat{0.f});
+      };
+
+      return {lerpComponent(0), lerpComponent(1), lerpComponent(2)};
+    }
+
+    simd::vfloat
+    LinearTransferFunction::opacityN(simd::vmaskf active,
+                                     const simd::vfloat &value) const
+    {
+      if (opacityValues.empty())
+        return simd::vfloat{1.0f};
+
+      const int numOpacities = static_cast<int>(opacityValues.size());
+
+      // NaN values compare false with themselves and are fully transparent
+      const auto valid = active & (value == value);
+
+      // Map the value into the range [0.0, numValues).
+      auto remapped = (value - valueRange.x)
+                      / (valueRange.y - valueRange.x)
+                      * (numOpacities - 1.0f);
+      remapped = simd::min(simd::max(remapped, 0.f), numOpacities - 1.0f);
+
+      // Compute the opacity indices and fractional offset.
+      const simd::vint index0    = simd::floori(remapped);
+      const simd::vint index1    = simd::min(index0 + 1, numOpacities - 1);
+      const simd::vfloat remainder = remapped - simd::cast<simd::vfloat>(index0);
+
+      const float *opacities = opacityValues.data();
+      const auto o0 = simd::vfloat::gather(valid, opacities, index0);
+      const auto o1 = simd::vfloat::gather(valid, opacities, index1);
+
+      // The interpolated opacity.
+      return simd::select(valid,
+                          (1.0f - remainder) * o0 + remainder * o1,
+                          simd::vfloat{0.f});
+    }
+
+    void LinearTransferFunction::preparePreIntegration()
+    {
+      if (preIntegrationTable.empty())
+        buildPreIntegrationTable();
+    }
+
+    void LinearTransferFunction::buildPreIntegrationTable()
+    {
+      const int   size  = PREINTEGRATION_TABLE_SIZE;
+      const float width = valueRange.y - valueRange.x;
+
+      auto valueAt = [&](float x) {
+        return valueRange.x + x / (size - 1.0f) * width;
+      };
+
+      // Integrals of (opacity weighted color, opacity) from the start of the
+      // value range up to each table value, in units of table cells. Each
+      // cell is integrated with a few sub-samples to catch control points
+      // between table values.
+      const int numSubSamples = 4;
+
+      std::vector<vec4f> integral(size);
+      integral[0] = vec4f{0.f};
+
+      for (int i = 1; i < size; ++i) {
+        vec4f sum {0.f};
+
+        for (int s = 0; s < numSubSamples; ++s) {
+          const float v = valueAt(i - 1 + (s + 0.5f) / numSubSamples);
+          const float a = opacity(v);
+          const vec3f c = a * color(v);
+          sum += vec4f{c.x, c.y, c.z, a};
+        }
+
+        integral[i] = integral[i - 1] + sum * (1.f / numSubSamples);
+      }
+
+      // NOTE(jda) - each entry is the average over the segment, assuming the
+      //             value changes linearly between the front and back sample;
+      //             a difference of two integrals makes every entry O(1)
+      preIntegrationTable.resize(size * size);
+
+      tasking::parallel_for(size, [&](int back) {
+        for (int front = 0; front < size; ++front) {
+          auto &entry = preIntegrationTable[back * size + front];
+
+          if (front == back) {
+            const float v = valueAt(front);
+            const vec3f c = color(v);
+            entry = vec4f{c.x, c.y, c.z, opacity(v)};
+            continue;
+          }
+
+          const vec4f average = (integral[back] - integral[front]) *
+                                (1.f / (back - front));
+
+          // Un-weight the color, renderers apply the opacity themselves.
+          const vec3f c = average.w > 0.f ?
+              vec3f{average.x, average.y, average.z} * (1.f / average.w) :
+              color(valueAt(0.5f * (front + back)));
+
+          entry = vec4f{c.x, c.y, c.z, average.w};
+        }
+      });
+    }
+
+    vec4f LinearTransferFunction::integrated(float value1, float value2) const
+    {
+      if (isnan(value1) || isnan(value2))
+        return vec4f{0.f};
+
+      const int size = PREINTEGRATION_TABLE_SIZE;
+
+      // Map the values into the range [0.0, size - 1].
+      auto remap = [&](float value) {
+        return ospcommon::clamp((value - valueRange.x)
+                                / (valueRange.y - valueRange.x)
+                                * (size - 1.0f),
+                                0.0f, size - 1.0f);
+      };
+
+      const float front = remap(value1);
+      const float back  = remap(value2);
+
+      const int   f0 = ospcommon::min(int(front), size - 2);
+      const int   b0 = ospcommon::min(int(back), size - 2);
+      const float ff = front - f0;
+      const float fb = back - b0;
+
+      auto entry = [&](int b, int f) -> const vec4f& {
+        return preIntegrationTable[b * size + f];
+      };
+
+      const vec4f lower = (1.f - ff) * entry(b0, f0) + ff * entry(b0, f0 + 1);
+      const vec4f upper = (1.f - ff) * entry(b0 + 1, f0) +
+                          ff * entry(b0 + 1, f0 + 1);
+
+      return (1.f - fb) * lower + fb * upper;
     }
 
     // A piecewise linear transfer function.
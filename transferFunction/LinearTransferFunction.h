@@ -43,12 +43,50 @@ namespace ospray {
       virtual float maxOpacity(const vec2f &range) const override;
       virtual vec2f minMaxOpacity(const vec2f &range) const override;
 
+      virtual void maxOpacities(const vec2f *ranges,
+                                float *results,
+                                size_t count) const override;
+
+      virtual void preparePreIntegration() override;
+
+      virtual simd::vec3f colorN(simd::vmaskf active,
+                                 const simd::vfloat &value) const override;
+
+      virtual simd::vfloat opacityN(simd::vmaskf active,
+                                    const simd::vfloat &value) const override;
+
       // Data members //
 
       std::vector<vec3f> colorValues;
       std::vector<float> opacityValues;
 
-      bool preIntegrationEnabled {false};
+      //! resolution of the pre-integration table along each value axis
+      static constexpr int PREINTEGRATION_TABLE_SIZE = 256;
+
+    private:
+
+      void buildOpacityRangeTable();
+      void buildPreIntegrationTable();
+
+      //! (min, max) of opacityValues[first..last], in O(1)
+      vec2f controlPointMinMax(int first, int last) const;
+
+      //! bilinear lookup of the pre-integrated (color, opacity) of the
+      //! segment from 'value1' to 'value2'
+      vec4f integrated(float value1, float value2) const;
+
+      /*! Pre-integrated (rgb, opacity) per (front value, back value) pair,
+          PREINTEGRATION_TABLE_SIZE^2 entries indexed [back][front], empty
+          until a volume using pre-integration prepares it for a frame. */
+      std::vector<vec4f> preIntegrationTable;
+
+      /*! Sparse table over opacityValues: level k holds the (min, max) of
+          the 2^k control points starting at each index, so any index range
+          is covered by two (overlapping) entries of one level. */
+      std::vector<std::vector<vec2f>> opacityRangeTable;
+
+      //! floor(log2(n)) for every range length n, indexes the level above
+      std::vector<int> opacityRangeLevel;
     };
 
   } // ::ospray::cpp_renderer
@@ -22,6 +22,7 @@ namespace ospray {
     void TransferFunction::commit()
     {
       valueRange = getParam2f("valueRange", vec2f(0.0f, 1.0f));
+      version++;
     }
 
     std::string TransferFunction::toString() const
@@ -29,6 +30,14 @@ namespace ospray {
       return "ospray::cpp_renderer::TransferFunction";
     }
 
+    void TransferFunction::maxOpacities(const vec2f *ranges,
+                                        float *results,
+                                        size_t count) const
+    {
+      for (size_t i = 0; i < count; ++i)
+        results[i] = maxOpacity(ranges[i]);
+    }
+
   } // ::ospray::cpp_renderer
 } // ::ospray
 
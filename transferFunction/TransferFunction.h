@@ -17,6 +17,8 @@
 #pragma once
 
 #include "transferFunction/TransferFunction.h"
+// cpp_renderer
+#include "../common/simd.h"
 
 namespace ospray {
   namespace cpp_renderer {
@@ -39,9 +41,29 @@ namespace ospray {
       virtual float maxOpacity(const vec2f &range) const = 0;
       virtual vec2f minMaxOpacity(const vec2f &range) const = 0;
 
+      //! maxOpacity() of 'count' ranges at once, e.g. to classify macro cells
+      virtual void maxOpacities(const vec2f *ranges,
+                                float *results,
+                                size_t count) const;
+
+      //! build what integratedColor()/integratedOpacity() look up, called
+      //! from a single thread before rendering
+      virtual void preparePreIntegration() {}
+
+      // SIMD sampling interface //
+
+      virtual simd::vec3f colorN(simd::vmaskf active,
+                                 const simd::vfloat &value) const = 0;
+
+      virtual simd::vfloat opacityN(simd::vmaskf active,
+                                    const simd::vfloat &value) const = 0;
+
       // Data members //
 
       vec2f valueRange {0.f, 1.f};
+
+      //! incremented by every commit, lets volumes cache derived data
+      int version {0};
     };
 
   } // ::ospray::cpp_renderer
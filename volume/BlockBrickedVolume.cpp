@@ -143,6 +143,15 @@ namespace ospray {
         free(finalSource);
       }
 
+      // Before the first commit the whole accelerator (and gradient volume)
+      // is built by commit().
+      if (finished) {
+        updateAccelerator(finalRegionCoords,
+                          finalRegionCoords + finalRegionSize - 1);
+        updateGradientVolume(finalRegionCoords,
+                             finalRegionCoords + finalRegionSize - 1);
+      }
+
       return true;
     }
 
@@ -175,6 +184,100 @@ namespace ospray {
       return inf;
     }
 
+    simd::vfloat BBV::computeSampleN(simd::vmaski active,
+                                     const simd::vec3f &worldCoordinates) const
+    {
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        return computeSampleN_T<uint8, BLOCK_VOXEL_COUNT>(active,
+                                                          worldCoordinates);
+        break;
+      case OSP_SHORT:
+        return computeSampleN_T<int16, BLOCK_VOXEL_COUNT>(active,
+                                                          worldCoordinates);
+        break;
+      case OSP_USHORT:
+        return computeSampleN_T<uint16, BLOCK_VOXEL_COUNT>(active,
+                                                           worldCoordinates);
+        break;
+      case OSP_FLOAT:
+        return computeSampleN_T<float, BLOCK_VOXEL_COUNT>(active,
+                                                          worldCoordinates);
+        break;
+      case OSP_DOUBLE:
+        return computeSampleN_T<double, BLOCK_VOXEL_COUNT>(active,
+                                                           worldCoordinates);
+        break;
+      default:
+        break;
+      }
+
+      return simd::vfloat{inf};
+    }
+
+    template<typename T, size_t VOXEL_COUNT>
+    inline void BBV::getVoxelNeighborhood_T(const vec3i &index,
+                                            float corners[8]) const
+    {
+      const int mask  = BRICK_VOXEL_BITMASK;
+      const int width = BRICK_VOXEL_WIDTH;
+
+      // NOTE(jda) - within a brick the corners are at fixed offsets from the
+      //             lower one, only cells straddling bricks need 8 addresses
+      const bool inBrick = (index.x & mask) < mask &&
+                           (index.y & mask) < mask &&
+                           (index.z & mask) < mask;
+
+      if (inBrick) {
+        const Address address = getVoxelAddress(index);
+        const T *voxels = (const T*)blockMem +
+                          VOXEL_COUNT * uint64(address.block) +
+                          address.voxel;
+
+        for (int k = 0; k < 8; ++k) {
+          const int offset = (k & 1) +
+                             ((k >> 1) & 1) * width +
+                             (k >> 2) * width * width;
+          corners[k] = float(voxels[offset]);
+        }
+      } else {
+        for (int k = 0; k < 8; ++k) {
+          const vec3i corner = index + vec3i{k & 1, (k >> 1) & 1, k >> 2};
+          corners[k] = getVoxelValue<T, VOXEL_COUNT>(getVoxelAddress(corner));
+        }
+      }
+    }
+
+    void BBV::getVoxelNeighborhood(const vec3i &index,
+                                   float corners[8]) const
+    {
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        getVoxelNeighborhood_T<uint8, BLOCK_VOXEL_COUNT>(index, corners);
+        break;
+      case OSP_SHORT:
+        getVoxelNeighborhood_T<int16, BLOCK_VOXEL_COUNT>(index, corners);
+        break;
+      case OSP_USHORT:
+        getVoxelNeighborhood_T<uint16, BLOCK_VOXEL_COUNT>(index, corners);
+        break;
+      case OSP_FLOAT:
+        getVoxelNeighborhood_T<float, BLOCK_VOXEL_COUNT>(index, corners);
+        break;
+      case OSP_DOUBLE:
+        getVoxelNeighborhood_T<double, BLOCK_VOXEL_COUNT>(index, corners);
+        break;
+      default:
+        StructuredVolume::getVoxelNeighborhood(index, corners);
+        break;
+      }
+    }
+
+    uint32 BBV::blockIndex(const vec3i &index) const
+    {
+      return getVoxelAddress(index).block;
+    }
+
     BBV::Address BBV::getVoxelAddress(const vec3i &index) const
     {
       Address address;
@@ -218,6 +321,50 @@ namespace ospray {
       return address;
     }
 
+    BBV::AddressN BBV::getVoxelAddress(const simd::vec3i &index) const
+    {
+      AddressN address;
+
+      // Compute the 3D index of the block containing the brick containing the
+      // voxel.
+      const simd::vec3i blockIndex {index.x >> BLOCK_VOXEL_WIDTH_BITCOUNT,
+                                    index.y >> BLOCK_VOXEL_WIDTH_BITCOUNT,
+                                    index.z >> BLOCK_VOXEL_WIDTH_BITCOUNT};
+
+      // Compute the 1D address of the block in the volume.
+      address.block = blockIndex.x
+                      + blockCount.x * (blockIndex.y
+                                        + blockCount.y * blockIndex.z);
+
+      // Compute the 3D offset of the brick within the block containing the
+      // voxel.
+      const simd::vec3i brickOffset {
+        (index.x >> BRICK_VOXEL_WIDTH_BITCOUNT) & BLOCK_BRICK_BITMASK,
+        (index.y >> BRICK_VOXEL_WIDTH_BITCOUNT) & BLOCK_BRICK_BITMASK,
+        (index.z >> BRICK_VOXEL_WIDTH_BITCOUNT) & BLOCK_BRICK_BITMASK
+      };
+
+      // Compute the 1D address of the brick in the block.
+      const simd::vint brickAddress
+        = brickOffset.x
+        + (brickOffset.y << BLOCK_BRICK_WIDTH_BITCOUNT)
+        + (brickOffset.z << 2 * BLOCK_BRICK_WIDTH_BITCOUNT);
+
+      // Compute the 3D offset of the voxel in the brick.
+      const simd::vec3i voxelOffset {index.x & BRICK_VOXEL_BITMASK,
+                                     index.y & BRICK_VOXEL_BITMASK,
+                                     index.z & BRICK_VOXEL_BITMASK};
+
+      // Compute the 1D address of the voxel in the block.
+      address.voxel
+        = brickAddress  << (3 * BRICK_VOXEL_WIDTH_BITCOUNT)
+        | voxelOffset.z << (2 * BRICK_VOXEL_WIDTH_BITCOUNT)
+        | voxelOffset.y << BRICK_VOXEL_WIDTH_BITCOUNT
+        | voxelOffset.x;
+
+      return address;
+    }
+
     void BlockBrickedVolume::constructVolumeMemory()
     {
       freeVolumeMemory();
@@ -35,6 +35,10 @@ namespace ospray {
                     const vec3i &index,
                     const vec3i &count) override;
 
+      simd::vfloat computeSampleN(simd::vmaski active,
+                                  const simd::vec3f &worldCoordinates)
+                                  const override;
+
     private:
 
       // Helper types //
@@ -48,15 +52,40 @@ namespace ospray {
         uint32 voxel;
       };
 
+      struct AddressN
+      {
+        //! The 1D address of the block in the volume containing each voxel.
+        simd::vint block;
+
+        //! The 1D offset of each voxel in its enclosing block.
+        simd::vint voxel;
+      };
+
       // StructuredVolume interface //
 
       float getVoxel(const vec3i &index) const override;
 
+      uint32 blockIndex(const vec3i &index) const override;
+
+      void getVoxelNeighborhood(const vec3i &index,
+                                float corners[8]) const override;
+
       // Helper functions //
 
       template <typename T, size_t BLOCK_VOXEL_COUNT>
       float getVoxelValue(const Address &address) const;
 
+      template <typename T, size_t BLOCK_VOXEL_COUNT>
+      void getVoxelNeighborhood_T(const vec3i &index, float corners[8]) const;
+
+      template <typename T, size_t BLOCK_VOXEL_COUNT>
+      simd::vfloat getVoxelValues(simd::vmaski active,
+                                  const AddressN &address) const;
+
+      template <typename T, size_t BLOCK_VOXEL_COUNT>
+      simd::vfloat computeSampleN_T(simd::vmaski active,
+                                    const simd::vec3f &worldCoordinates) const;
+
       template <typename T, size_t BLOCK_VOXEL_COUNT>
       void setVoxelValues(void *_source,
                           const vec3i &targetCoord000,
@@ -64,6 +93,7 @@ namespace ospray {
                           size_t taskIndex);
 
       Address getVoxelAddress(const vec3i &index) const;
+      AddressN getVoxelAddress(const simd::vec3i &index) const;
 
       void constructVolumeMemory();
       void freeVolumeMemory();
@@ -93,6 +123,70 @@ namespace ospray {
       return float(blockPtr[address.voxel]);
     }
 
+    template<typename T, size_t BLOCK_VOXEL_COUNT>
+    inline simd::vfloat
+    BlockBrickedVolume::getVoxelValues(simd::vmaski active,
+                                       const AddressN &address) const
+    {
+      return gatherVoxels<T>(active,
+                             blockMem,
+                             BLOCK_VOXEL_COUNT * sizeof(T),
+                             address.block,
+                             address.voxel * int(sizeof(T)));
+    }
+
+    template<typename T, size_t BLOCK_VOXEL_COUNT>
+    inline simd::vfloat
+    BlockBrickedVolume::computeSampleN_T(simd::vmaski active,
+                                         const simd::vec3f &worldCoordinates)
+                                         const
+    {
+      const simd::vec3f clampedLocalCoordinates =
+          clampToVolume(transformWorldToLocal(worldCoordinates));
+
+      // Lower and upper corners of the box straddling the voxels to be
+      // interpolated. "vi" means "voxelIndex"
+      const simd::vec3i vi_0 {simd::floori(clampedLocalCoordinates.x),
+                              simd::floori(clampedLocalCoordinates.y),
+                              simd::floori(clampedLocalCoordinates.z)};
+      const simd::vec3i vi_1 {vi_0.x + 1, vi_0.y + 1, vi_0.z + 1};
+
+      // Fractional coordinates within the lower corner voxel used during
+      // interpolation. "flc" means "fractionalLocalCoordinates"
+      const simd::vec3f flc {
+        clampedLocalCoordinates.x - simd::cast<simd::vfloat>(vi_0.x),
+        clampedLocalCoordinates.y - simd::cast<simd::vfloat>(vi_0.y),
+        clampedLocalCoordinates.z - simd::cast<simd::vfloat>(vi_0.z)
+      };
+
+      // Look up the voxel values to be interpolated. "vv" means "voxelValue"
+      auto fetch = [&](const simd::vint &x,
+                       const simd::vint &y,
+                       const simd::vint &z) {
+        const auto address = getVoxelAddress(simd::vec3i{x, y, z});
+        return getVoxelValues<T, BLOCK_VOXEL_COUNT>(active, address);
+      };
+
+      const simd::vfloat vv_000 = fetch(vi_0.x, vi_0.y, vi_0.z);
+      const simd::vfloat vv_001 = fetch(vi_1.x, vi_0.y, vi_0.z);
+      const simd::vfloat vv_010 = fetch(vi_0.x, vi_1.y, vi_0.z);
+      const simd::vfloat vv_011 = fetch(vi_1.x, vi_1.y, vi_0.z);
+      const simd::vfloat vv_100 = fetch(vi_0.x, vi_0.y, vi_1.z);
+      const simd::vfloat vv_101 = fetch(vi_1.x, vi_0.y, vi_1.z);
+      const simd::vfloat vv_110 = fetch(vi_0.x, vi_1.y, vi_1.z);
+      const simd::vfloat vv_111 = fetch(vi_1.x, vi_1.y, vi_1.z);
+
+      // Interpolate the voxel values.
+      const simd::vfloat vv_00 = vv_000 + flc.x * (vv_001 - vv_000);
+      const simd::vfloat vv_01 = vv_010 + flc.x * (vv_011 - vv_010);
+      const simd::vfloat vv_10 = vv_100 + flc.x * (vv_101 - vv_100);
+      const simd::vfloat vv_11 = vv_110 + flc.x * (vv_111 - vv_110);
+      const simd::vfloat vv_0  = vv_00  + flc.y * (vv_01  - vv_00 );
+      const simd::vfloat vv_1  = vv_10  + flc.y * (vv_11  - vv_10 );
+
+      return vv_0 + flc.z * (vv_1 - vv_0);
+    }
+
     template<typename T, size_t BLOCK_VOXEL_COUNT>
     inline void BlockBrickedVolume::setVoxelValues(void *_source,
                                                    const vec3i &targetCoord000,
@@ -182,6 +182,54 @@ namespace ospray {
       return addr;
     }
 
+    /*! SIMD version of brickTranslation() */
+    template<typename VOXEL_T>
+    inline Address8N brickTranslation(const simd::vec3i &voxelIdxInBlock)
+    {
+      Address8N addr;
+
+      const simd::vec3i brickIdxInBlock {voxelIdxInBlock.x >> BRICK_BITS,
+                                         voxelIdxInBlock.y >> BRICK_BITS,
+                                         voxelIdxInBlock.z >> BRICK_BITS};
+      const simd::vec3i voxelIdxInBrick {voxelIdxInBlock.x & BRICK_MASK,
+                                         voxelIdxInBlock.y & BRICK_MASK,
+                                         voxelIdxInBlock.z & BRICK_MASK};
+
+      const int scale = scale_per<VOXEL_T>::value;
+      const int shift = shift_per<VOXEL_T>::value;
+
+      addr.voxelOfs_dx = simd::select(
+        voxelIdxInBrick.x == (BRICK_WIDTH-1),
+        simd::vint{(BRICK_BIT_SCALE_X_HI*scale)
+                   - ((BRICK_WIDTH-1)*BRICK_BIT_SCALE_X_LO*scale)},
+        simd::vint{BRICK_BIT_SCALE_X_LO*scale}
+      );
+
+      addr.voxelOfs_dy = simd::select(
+        voxelIdxInBrick.y == (BRICK_WIDTH-1),
+        simd::vint{(BRICK_BIT_SCALE_Y_HI*scale)
+                   - ((BRICK_WIDTH-1)*BRICK_BIT_SCALE_Y_LO*scale)},
+        simd::vint{BRICK_BIT_SCALE_Y_LO*scale}
+      );
+
+      addr.voxelOfs_dz = simd::select(
+        voxelIdxInBrick.z == (BRICK_WIDTH-1),
+        simd::vint{(BRICK_BIT_SCALE_Z_HI*scale)
+                   - ((BRICK_WIDTH-1)*BRICK_BIT_SCALE_Z_LO*scale)},
+        simd::vint{BRICK_BIT_SCALE_Z_LO*scale}
+      );
+
+      addr.voxelOfs =
+        (voxelIdxInBrick.x << (BRICK_BIT_X_LO+shift)) |
+        (voxelIdxInBrick.y << (BRICK_BIT_Y_LO+shift)) |
+        (voxelIdxInBrick.z << (BRICK_BIT_Z_LO+shift)) |
+        (brickIdxInBlock.x << (BRICK_BIT_X_HI+shift)) |
+        (brickIdxInBlock.y << (BRICK_BIT_Y_HI+shift)) |
+        (brickIdxInBlock.z << (BRICK_BIT_Z_HI+shift));
+
+      return addr;
+    }
+
     template<typename T>
     inline float accessArrayWithOffset(const T *basePtr, uint32 offset)
     {
@@ -281,12 +329,95 @@ namespace ospray {
         free(finalSource);
       }
 
+      // Before the first commit the whole accelerator (and gradient volume)
+      // is built by commit().
+      if (finished) {
+        updateAccelerator(finalRegionCoords,
+                          finalRegionCoords + finalRegionSize - 1);
+        updateGradientVolume(finalRegionCoords,
+                             finalRegionCoords + finalRegionSize - 1);
+      }
+
       return true;
     }
 
     float GhostBlockBrickedVolume::getVoxel(const vec3i &index) const
     {
-      NOT_IMPLEMENTED// NOTE(jda) - not needed...
+      // NOTE(jda) - the voxel itself, not one of its ghost copies
+      const Address address = getIndices(index);
+
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        return getVoxelValue<uint8, VOXELS_PER_BLOCK>(address);
+        break;
+      case OSP_SHORT:
+        return getVoxelValue<int16, VOXELS_PER_BLOCK>(address);
+        break;
+      case OSP_USHORT:
+        return getVoxelValue<uint16, VOXELS_PER_BLOCK>(address);
+        break;
+      case OSP_FLOAT:
+        return getVoxelValue<float, VOXELS_PER_BLOCK>(address);
+        break;
+      case OSP_DOUBLE:
+        return getVoxelValue<double, VOXELS_PER_BLOCK>(address);
+        break;
+      default:
+        break;
+      }
+
+      return inf;
+    }
+
+    uint32 GhostBlockBrickedVolume::blockIndex(const vec3i &index) const
+    {
+      return getVoxelAddress(vec3f{index}, index).block;
+    }
+
+    void GhostBlockBrickedVolume::getVoxelNeighborhood(const vec3i &index,
+                                                       float corners[8]) const
+    {
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        getVoxelNeighborhood_T<uint8>(index, corners);
+        break;
+      case OSP_SHORT:
+        getVoxelNeighborhood_T<int16>(index, corners);
+        break;
+      case OSP_USHORT:
+        getVoxelNeighborhood_T<uint16>(index, corners);
+        break;
+      case OSP_FLOAT:
+        getVoxelNeighborhood_T<float>(index, corners);
+        break;
+      case OSP_DOUBLE:
+        getVoxelNeighborhood_T<double>(index, corners);
+        break;
+      default:
+        StructuredVolume::getVoxelNeighborhood(index, corners);
+        break;
+      }
+    }
+
+    template<typename T>
+    void
+    GhostBlockBrickedVolume::getVoxelNeighborhood_T(const vec3i &index,
+                                                    float corners[8]) const
+    {
+      /* The ghost voxels put all 8 corners in one block, at the offsets
+         encoded in the address. */
+      const Address8 address8 = getVoxelAddress(vec3f{index}, index);
+
+      const T *blockPtr = (const T*)blockMem
+                          + ((uint64)address8.block) * (VOXELS_PER_BLOCK);
+
+      for (int k = 0; k < 8; ++k) {
+        const uint32 ofs = address8.voxelOfs
+                           + ((k & 1)        ? address8.voxelOfs_dx : 0)
+                           + (((k >> 1) & 1) ? address8.voxelOfs_dy : 0)
+                           + ((k >> 2)       ? address8.voxelOfs_dz : 0);
+        corners[k] = accessArrayWithOffset(blockPtr, ofs);
+      }
     }
 
     float
@@ -380,6 +511,102 @@ namespace ospray {
       return val;
     }
 
+    simd::vfloat
+    GhostBlockBrickedVolume::computeSampleN(simd::vmaski active,
+                                            const simd::vec3f &worldCoordinates)
+                                            const
+    {
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        return computeSampleN_T<uint8>(active, worldCoordinates);
+        break;
+      case OSP_SHORT:
+        return computeSampleN_T<int16>(active, worldCoordinates);
+        break;
+      case OSP_USHORT:
+        return computeSampleN_T<uint16>(active, worldCoordinates);
+        break;
+      case OSP_FLOAT:
+        return computeSampleN_T<float>(active, worldCoordinates);
+        break;
+      case OSP_DOUBLE:
+        return computeSampleN_T<double>(active, worldCoordinates);
+        break;
+      default:
+        break;
+      }
+
+      return simd::vfloat{inf};
+    }
+
+    template<typename T>
+    simd::vfloat
+    GhostBlockBrickedVolume::computeSampleN_T(simd::vmaski active,
+                                              const simd::vec3f &worldCoordinates)
+                                              const
+    {
+      /* Transform the sample location into the local coordinate system and */
+      /* clamp coordinates outside the volume to the volume bounds. */
+      const simd::vec3f clampedLocalCoordinates =
+          clampToVolume(transformWorldToLocal(worldCoordinates));
+
+      // "vi" means "voxelIndex"
+      const simd::vec3i vi_0 {simd::floori(clampedLocalCoordinates.x),
+                              simd::floori(clampedLocalCoordinates.y),
+                              simd::floori(clampedLocalCoordinates.z)};
+
+      const simd::vec3f flc {
+        clampedLocalCoordinates.x - simd::cast<simd::vfloat>(vi_0.x),
+        clampedLocalCoordinates.y - simd::cast<simd::vfloat>(vi_0.y),
+        clampedLocalCoordinates.z - simd::cast<simd::vfloat>(vi_0.z)
+      };
+
+      /* Compute the 1D address of the block in the volume and the voxel in */
+      /* the block for all lanes at once. */
+      const Address8N address8 =
+          getVoxelAddress<T>(clampedLocalCoordinates, vi_0);
+
+      /* The blocks are addressed with 64 bits inside gatherVoxels(), so */
+      /* lanes only have to carry the (32 bit) byte offsets within a block. */
+      auto fetch = [&](const simd::vint &ofs) {
+        return gatherVoxels<T>(active,
+                               blockMem,
+                               VOXELS_PER_BLOCK * sizeof(T),
+                               address8.block,
+                               ofs);
+      };
+
+      const simd::vint ofs000 = address8.voxelOfs;
+      const simd::vint ofs001 = ofs000 + address8.voxelOfs_dx;
+      const simd::vfloat val000 = fetch(ofs000);
+      const simd::vfloat val001 = fetch(ofs001);
+      const simd::vfloat val00  = val000 + flc.x * (val001 - val000);
+
+      const simd::vint ofs010 = ofs000 + address8.voxelOfs_dy;
+      const simd::vint ofs011 = ofs001 + address8.voxelOfs_dy;
+      const simd::vfloat val010 = fetch(ofs010);
+      const simd::vfloat val011 = fetch(ofs011);
+      const simd::vfloat val01  = val010 + flc.x * (val011 - val010);
+
+      const simd::vint ofs100 = ofs000 + address8.voxelOfs_dz;
+      const simd::vint ofs101 = ofs001 + address8.voxelOfs_dz;
+      const simd::vfloat val100 = fetch(ofs100);
+      const simd::vfloat val101 = fetch(ofs101);
+      const simd::vfloat val10  = val100 + flc.x * (val101 - val100);
+
+      const simd::vint ofs110 = ofs010 + address8.voxelOfs_dz;
+      const simd::vint ofs111 = ofs011 + address8.voxelOfs_dz;
+      const simd::vfloat val110 = fetch(ofs110);
+      const simd::vfloat val111 = fetch(ofs111);
+      const simd::vfloat val11  = val110 + flc.x * (val111 - val110);
+
+      /* Interpolate the voxel values. */
+      const simd::vfloat val0 = val00 + flc.y * (val01 - val00);
+      const simd::vfloat val1 = val10 + flc.y * (val11 - val10);
+
+      return val0 + flc.z * (val1 - val0);
+    }
+
     Address GhostBlockBrickedVolume::getIndices(const vec3i &voxelIdxInVolume) const
     {
       Address address;
@@ -521,6 +748,33 @@ namespace ospray {
       return address;
     }
 
+    template<typename T>
+    Address8N GBBV::getVoxelAddress(const simd::vec3f &indexf,
+                                    const simd::vec3i &indexi) const
+    {
+      /* Compute the 3D index of the block containing the brick containing the voxel. */
+      const float rcpBlockWidth = 1.f/(BLOCK_WIDTH-1.f);
+      const simd::vec3i blockIndex {simd::floori(indexf.x * rcpBlockWidth),
+                                    simd::floori(indexf.y * rcpBlockWidth),
+                                    simd::floori(indexf.z * rcpBlockWidth)};
+
+      /* Compute the 3D offset of the brick within the block containing the voxel. */
+      const simd::vec3i voxelIdxInBlock {
+        indexi.x - blockIndex.x * (BLOCK_WIDTH-1),
+        indexi.y - blockIndex.y * (BLOCK_WIDTH-1),
+        indexi.z - blockIndex.z * (BLOCK_WIDTH-1)
+      };
+
+      Address8N address = brickTranslation<T>(voxelIdxInBlock);
+
+      /* Compute the 1D address of the block in the volume. */
+      address.block = blockIndex.x
+                      + blockCount.x * (blockIndex.y
+                                        + blockCount.y * blockIndex.z);
+
+      return address;
+    }
+
     void GhostBlockBrickedVolume::constructVolumeMemory()
     {
       freeVolumeMemory();
@@ -51,6 +51,23 @@ namespace ospray {
       uint32 voxelOfs_dz;
     };
 
+    /*! SIMD version of Address8, holding the addresses of one packet of
+        sample positions */
+    struct Address8N
+    {
+      //! The 1D address of the block in the volume containing the voxel.
+      simd::vint block;
+
+      //! The 1D offset (in bytes!) of the voxel in the enclosing block.
+      simd::vint voxelOfs;
+      //! offset to the next voxel in x direction (see Address8)
+      simd::vint voxelOfs_dx;
+      //! offset to the next voxel in y direction (see Address8)
+      simd::vint voxelOfs_dy;
+      //! offset to the next voxel in z direction (see Address8)
+      simd::vint voxelOfs_dz;
+    };
+
     class GhostBlockBrickedVolume : public StructuredVolume
     {
     public:
@@ -65,14 +82,26 @@ namespace ospray {
                     const vec3i &index,
                     const vec3i &count) override;
 
+      simd::vfloat computeSampleN(simd::vmaski active,
+                                  const simd::vec3f &worldCoordinates)
+                                  const override;
+
     private:
 
       // StructuredVolume interface //
 
       float getVoxel(const vec3i &index) const override;
+      uint32 blockIndex(const vec3i &index) const override;
+      void getVoxelNeighborhood(const vec3i &index,
+                                float corners[8]) const override;
+      template <typename T>
+      void getVoxelNeighborhood_T(const vec3i &index, float corners[8]) const;
       float computeSample(const vec3f &worldCoordinates) const override;
       template <typename T>
       float computeSample_T(const vec3f &worldCoordinates) const;
+      template <typename T>
+      simd::vfloat computeSampleN_T(simd::vmaski active,
+                                    const simd::vec3f &worldCoordinates) const;
 
       // Helper functions //
 
@@ -90,6 +119,9 @@ namespace ospray {
                            const vec3i &delta,
                            Address     &address) const;
       Address8 getVoxelAddress(const vec3f &indexf, const vec3i &indexi) const;
+      template <typename T>
+      Address8N getVoxelAddress(const simd::vec3f &indexf,
+                                const simd::vec3i &indexi) const;
 
       void constructVolumeMemory();
       void freeVolumeMemory();
@@ -116,7 +148,9 @@ namespace ospray {
     inline float
     GhostBlockBrickedVolume::getVoxelValue(const Address &address) const
     {
-      NOT_IMPLEMENTED
+      const T *blockPtr = (const T*)blockMem +
+                          address.block * (uint64)BLOCK_VOXEL_COUNT;
+      return float(blockPtr[address.voxel]);
     }
 
     template<typename T, size_t VOXELS_PER_BLOCK>
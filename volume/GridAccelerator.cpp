@@ -0,0 +1,78 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "GridAccelerator.h"
+// ospray
+#include "ospcommon/tasking/parallel_for.h"
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    constexpr int GridAccelerator::CELL_WIDTH;
+
+    void GridAccelerator::resize(const vec3i &volumeDimensions)
+    {
+      // NOTE(jda) - cells cover voxel intervals, there is one less interval
+      //             than voxels along each axis
+      const vec3i intervals = max(volumeDimensions - 1, vec3i(1));
+
+      numCells = (intervals + CELL_WIDTH - 1) / CELL_WIDTH;
+
+      const size_t n = size_t(numCells.x) * numCells.y * numCells.z;
+
+      cellRange.assign(n, vec2f(FLT_MAX, -FLT_MAX));
+      cellMaxOpacity.assign(n, 1.f);
+
+      invalidate();
+    }
+
+    void GridAccelerator::classify(const TransferFunction &tf)
+    {
+      if (&tf == classifiedTF && tf.version == classifiedVersion)
+        return;
+
+      // NOTE(jda) - one batch per slice of cells, cells are stored x-first
+      const size_t sliceCells = size_t(numCells.x) * numCells.y;
+
+      tasking::parallel_for(numCells.z, [&](int z) {
+        const size_t first = z * sliceCells;
+        tf.maxOpacities(&cellRange[first], &cellMaxOpacity[first],
+                        sliceCells);
+
+        // NOTE(jda) - cells without voxel data yet are kept non-empty
+        for (size_t i = first; i < first + sliceCells; ++i) {
+          if (cellRange[i].x > cellRange[i].y)
+            cellMaxOpacity[i] = 1.f;
+        }
+      });
+
+      classifiedTF      = &tf;
+      classifiedVersion = tf.version;
+    }
+
+    void GridAccelerator::cellsOfVoxels(const vec3i &lower,
+                                        const vec3i &upper,
+                                        vec3i &firstCell,
+                                        vec3i &lastCell) const
+    {
+      // NOTE(jda) - voxels on a cell boundary belong to both cells
+      const vec3i last = numCells - 1;
+      firstCell = clamp((lower - 1) / CELL_WIDTH, vec3i(0), last);
+      lastCell  = clamp(upper / CELL_WIDTH, vec3i(0), last);
+    }
+
+  } // ::ospray::cpp_renderer
+} // ::ospray
@@ -0,0 +1,137 @@
+// ======================================================================== //
+// Copyright 2009-2016 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// cpp_renderer
+#include "../transferFunction/TransferFunction.h"
+// std
+#include <cstdint>
+#include <vector>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief macro-cell grid over a structured volume for empty space
+     *         skipping
+
+        Each cell covers CELL_WIDTH^3 voxel *intervals*, i.e. the voxels
+        [c*CELL_WIDTH, (c+1)*CELL_WIDTH] along each axis, so neighboring
+        cells share a layer of voxels and every trilinear sample taken inside
+        a cell only depends on voxels of that cell. The grid stores the voxel
+        value range of each cell (owned by the volume, which knows its
+        voxels) and, for one transfer function, the maximum opacity of each
+        cell: cells with a maximum opacity of 0 are empty, the others set
+        the rate of adaptive sampling. */
+    struct GridAccelerator
+    {
+      //! width of a cell in voxel intervals
+      static constexpr int CELL_WIDTH = 8;
+
+      //! \brief (re)allocate the grid for a volume, clears all cell ranges
+      void resize(const vec3i &volumeDimensions);
+
+      /*! \brief compute the maximum opacity of all cells for 'tf', if it
+       *         changed since the last call */
+      void classify(const TransferFunction &tf);
+
+      //! \brief the cells overlapping the voxels [lower, upper]
+      void cellsOfVoxels(const vec3i &lower, const vec3i &upper,
+                         vec3i &firstCell, vec3i &lastCell) const;
+
+      bool classified() const;
+
+      vec3i cellCount() const;
+      int   cellIndex(const vec3i &cell) const;
+
+      //! \brief the cell containing local (voxel) coordinates 'p', clamped
+      vec3i cellAt(const vec3f &p) const;
+
+      bool  isEmpty(const vec3i &cell) const;
+      float maxOpacity(const vec3i &cell) const;
+
+      //! \brief value range of the voxels of a cell, set by the volume
+      vec2f &range(int cellIndex);
+      const vec2f &range(int cellIndex) const;
+
+      //! \brief make the next classify() reclassify all cells
+      void invalidate();
+
+    private:
+
+      vec3i numCells {0};
+
+      std::vector<vec2f> cellRange;
+      std::vector<float> cellMaxOpacity;
+
+      // transfer function the cells were classified for
+      const TransferFunction *classifiedTF {nullptr};
+      int classifiedVersion {-1};
+    };
+
+    // Inlined member functions ///////////////////////////////////////////////
+
+    inline bool GridAccelerator::classified() const
+    {
+      return classifiedTF != nullptr;
+    }
+
+    inline vec3i GridAccelerator::cellCount() const
+    {
+      return numCells;
+    }
+
+    inline int GridAccelerator::cellIndex(const vec3i &cell) const
+    {
+      return (cell.z * numCells.y + cell.y) * numCells.x + cell.x;
+    }
+
+    inline vec3i GridAccelerator::cellAt(const vec3f &p) const
+    {
+      const float rcpWidth = 1.f / CELL_WIDTH;
+      return vec3i(ospcommon::clamp(int(p.x * rcpWidth), 0, numCells.x - 1),
+                   ospcommon::clamp(int(p.y * rcpWidth), 0, numCells.y - 1),
+                   ospcommon::clamp(int(p.z * rcpWidth), 0, numCells.z - 1));
+    }
+
+    inline bool GridAccelerator::isEmpty(const vec3i &cell) const
+    {
+      return cellMaxOpacity[cellIndex(cell)] <= 0.f;
+    }
+
+    inline float GridAccelerator::maxOpacity(const vec3i &cell) const
+    {
+      return cellMaxOpacity[cellIndex(cell)];
+    }
+
+    inline vec2f &GridAccelerator::range(int cellIndex)
+    {
+      return cellRange[cellIndex];
+    }
+
+    inline const vec2f &GridAccelerator::range(int cellIndex) const
+    {
+      return cellRange[cellIndex];
+    }
+
+    inline void GridAccelerator::invalidate()
+    {
+      classifiedTF      = nullptr;
+      classifiedVersion = -1;
+    }
+
+  } // ::ospray::cpp_renderer
+} // ::ospray
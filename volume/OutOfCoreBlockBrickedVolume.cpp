@@ -0,0 +1,699 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+//ospray
+#include "OutOfCoreBlockBrickedVolume.h"
+#include "ospcommon/tasking/parallel_for.h"
+// std
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+// posix
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//! The number of bits used to represent the width of a Block in voxels.
+#define BLOCK_VOXEL_WIDTH_BITCOUNT (6)
+
+//! The number of bits used to represent the width of a brick in voxels.
+#define BRICK_VOXEL_WIDTH_BITCOUNT (2)
+
+//! The number of bits used to represent the width of a block in bricks.
+#define BLOCK_BRICK_WIDTH_BITCOUNT (BLOCK_VOXEL_WIDTH_BITCOUNT - BRICK_VOXEL_WIDTH_BITCOUNT)
+
+//! The width of a block in voxels.
+#define BLOCK_VOXEL_WIDTH (1 << BLOCK_VOXEL_WIDTH_BITCOUNT)
+
+//! The width of a brick in voxels.
+#define BRICK_VOXEL_WIDTH (1 << BRICK_VOXEL_WIDTH_BITCOUNT)
+
+//! The width of a block in bricks.
+#define BLOCK_BRICK_WIDTH (1 << BLOCK_BRICK_WIDTH_BITCOUNT)
+
+//! The bits denoting the offset of a brick within a block.
+#define BLOCK_BRICK_BITMASK (BLOCK_BRICK_WIDTH - 1)
+
+//! The bits denoting the offset of a voxel within a brick.
+#define BRICK_VOXEL_BITMASK (BRICK_VOXEL_WIDTH - 1)
+
+//! Where the unnamed backing file goes when "blockFile" isn't set.
+#define DEFAULT_BLOCK_DIRECTORY "/var/tmp"
+
+//! The number of voxels contained in a block.
+#define BLOCK_VOXEL_COUNT (BLOCK_VOXEL_WIDTH * BLOCK_VOXEL_WIDTH * BLOCK_VOXEL_WIDTH)
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    using OOCBBV = OutOfCoreBlockBrickedVolume;
+
+    // Helper functions ///////////////////////////////////////////////////////
+
+    //! source of OOCBBV::generation values, shared so that a volume
+    //! allocated at the address of a deleted one never matches its blocks
+    static std::atomic<uint64> nextGeneration {1};
+
+    static std::string systemError(const std::string &what)
+    {
+      return "cpp_ooc_bbv: " + what + " (" + std::strerror(errno) + ")";
+    }
+
+    // OutOfCoreBlockBrickedVolume definitions ////////////////////////////////
+
+    thread_local OOCBBV::LastBlock OOCBBV::lastBlock;
+
+    OOCBBV::OutOfCoreBlockBrickedVolume()
+      : generation(nextGeneration++)
+    {
+    }
+
+    OOCBBV::~OutOfCoreBlockBrickedVolume()
+    {
+      if (logLevel() >= 2 && mappedMem) {
+        const auto s = cacheStats();
+        std::cout << "ospray: " << toString() << " block cache: " << s.hits
+                  << " hits, " << s.misses << " misses, " << s.evictions
+                  << " evictions, " << s.prefetches << " prefetches"
+                  << std::endl;
+      }
+
+      freeVolumeMemory();
+    }
+
+    std::string OOCBBV::toString() const
+    {
+      return("ospray::cpp_renderer::OutOfCoreBBV<" + voxelType + ">");
+    }
+
+    void OOCBBV::commit()
+    {
+      // NOTE(jda) - a gradient volume is 3 bytes per voxel in RAM, which is
+      //             what this volume exists to avoid
+      if (getParam1i("gradientVolume", 0)) {
+        throw std::runtime_error("cpp_ooc_bbv: \"gradientVolume\" isn't "
+                                 "supported, gradients are computed from the "
+                                 "voxels");
+      }
+
+      if (!mappedMem) constructVolumeMemory();
+
+      const size_t cacheBytes =
+          size_t(std::max(getParam1i("cacheSize", 1024), 1)) << 20;
+      {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        maxCachedBlocks = std::max<size_t>(cacheBytes / blockBytes, 1);
+        evictBlocks(maxCachedBlocks);
+      }
+
+      StructuredVolume::commit();
+
+      prefetchDistance = getParam1f("prefetchDistance", 1.f) *
+                         BLOCK_VOXEL_WIDTH * reduce_min(gridSpacing);
+    }
+
+    int OOCBBV::setRegion(
+        // points to the first voxel to be copied. The voxels at 'source' MUST
+        // have dimensions 'regionSize', must be organized in 3D-array order,and
+        // must have the same voxel type as the volume.
+        const void *source,
+        // coordinates of the lower, left, front corner of the target region
+        const vec3i &regionCoords,
+        // size of the region that we're writing to, MUST be the same as the
+        // dimensions of source[][][]
+        const vec3i &regionSize)
+    {
+      vec3i finalRegionSize   = regionSize;
+      vec3i finalRegionCoords = regionCoords;
+      void *finalSource       = const_cast<void*>(source);
+
+      const bool upsampling = scaleRegion(source, finalSource,
+                                          finalRegionSize, finalRegionCoords);
+      // Copy voxel data into the volume.
+      const size_t NTASKS = finalRegionSize.y * finalRegionSize.z;
+
+      if (voxel_t == OSP_UNKNOWN)
+        constructVolumeMemory();
+
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        tasking::parallel_for(NTASKS, [&](size_t taskIndex) {
+          setVoxelValues<uint8>(finalSource, finalRegionCoords,
+                                finalRegionSize, taskIndex);
+        });
+        break;
+      case OSP_SHORT:
+        tasking::parallel_for(NTASKS, [&](size_t taskIndex) {
+          setVoxelValues<int16>(finalSource, finalRegionCoords,
+                                finalRegionSize, taskIndex);
+        });
+        break;
+      case OSP_USHORT:
+        tasking::parallel_for(NTASKS, [&](size_t taskIndex) {
+          setVoxelValues<uint16>(finalSource, finalRegionCoords,
+                                 finalRegionSize, taskIndex);
+        });
+        break;
+      case OSP_FLOAT:
+        tasking::parallel_for(NTASKS, [&](size_t taskIndex) {
+          setVoxelValues<float>(finalSource, finalRegionCoords,
+                                finalRegionSize, taskIndex);
+        });
+        break;
+      case OSP_DOUBLE:
+        tasking::parallel_for(NTASKS, [&](size_t taskIndex) {
+          setVoxelValues<double>(finalSource, finalRegionCoords,
+                                 finalRegionSize, taskIndex);
+        });
+        break;
+      default:
+        throw std::runtime_error("No voxel_t specificed in cpp ooc bbv!");
+        break;
+      }
+
+      // If we're upsampling finalSource points at the chunk of data allocated by
+      // scaleRegion to hold the upsampled volume data and we must free it.
+      if (upsampling) {
+        free(finalSource);
+      }
+
+      const vec3i lower = max(finalRegionCoords, vec3i(0));
+      const vec3i upper = min(finalRegionCoords + finalRegionSize - 1,
+                              dimensions - 1);
+
+      if (lower.x > upper.x || lower.y > upper.y || lower.z > upper.z)
+        return true;
+
+      invalidateBlocks(lower, upper);
+
+      // Before the first commit the whole accelerator (and gradient volume)
+      // is built by commit().
+      if (finished) {
+        updateAccelerator(lower, upper);
+        updateGradientVolume(lower, upper);
+      }
+
+      return true;
+    }
+
+    float OOCBBV::computeSample(const vec3f &worldCoordinates) const
+    {
+      const vec3f clampedLocalCoordinates =
+          clamp(transformWorldToLocal(worldCoordinates),
+                vec3f{0.0f},
+                localCoordinatesUpperBound);
+
+      // Lower corner of the box straddling the voxels to be interpolated.
+      const vec3i vi_0 {clampedLocalCoordinates.x,
+                        clampedLocalCoordinates.y,
+                        clampedLocalCoordinates.z};
+
+      // Fractional coordinates within the lower corner voxel used during
+      // interpolation. "flc" means "fractionalLocalCoordinates"
+      const vec3f flc = clampedLocalCoordinates - vec3f{vi_0.x, vi_0.y, vi_0.z};
+
+      // NOTE(jda) - fetch all 8 voxels at once, usually from a single block
+      float vv[8];
+      getVoxelNeighborhood(vi_0, vv);
+
+      // Interpolate the voxel values.
+      const float vv_00 = vv[0] + flc.x * (vv[1] - vv[0]);
+      const float vv_01 = vv[2] + flc.x * (vv[3] - vv[2]);
+      const float vv_10 = vv[4] + flc.x * (vv[5] - vv[4]);
+      const float vv_11 = vv[6] + flc.x * (vv[7] - vv[6]);
+      const float vv_0  = vv_00 + flc.y * (vv_01 - vv_00);
+      const float vv_1  = vv_10 + flc.y * (vv_11 - vv_10);
+
+      return vv_0 + flc.z * (vv_1 - vv_0);
+    }
+
+    bool OOCBBV::intersect(Ray &ray) const
+    {
+      const bool hit = StructuredVolume::intersect(ray);
+
+      if (hit && prefetchDistance > 0.f) {
+        prefetchBlock(blockAt(ray.org + ray.t0 * ray.dir));
+        const float tAhead = std::min(ray.t0 + prefetchDistance, ray.t);
+        prefetchBlock(blockAt(ray.org + tAhead * ray.dir));
+      }
+
+      return hit;
+    }
+
+    void OOCBBV::advance(Ray &ray) const
+    {
+      const float tPrevious = ray.t0;
+      StructuredVolume::advance(ray);
+      prefetchAlongRay(ray.org, ray.dir, tPrevious, ray.t0, ray.t);
+    }
+
+    void OOCBBV::advanceAdaptive(Ray &ray) const
+    {
+      const float tPrevious = ray.t0;
+      StructuredVolume::advanceAdaptive(ray);
+      prefetchAlongRay(ray.org, ray.dir, tPrevious, ray.t0, ray.t);
+    }
+
+    void OOCBBV::advanceN(simd::vmaski active, RayN &ray) const
+    {
+      const simd::vfloat tPrevious = ray.t0;
+      StructuredVolume::advanceN(active, ray);
+
+      simd::foreach_active(active, [&](int i) {
+        prefetchAlongRay(vec3f{ray.org.x[i], ray.org.y[i], ray.org.z[i]},
+                         vec3f{ray.dir.x[i], ray.dir.y[i], ray.dir.z[i]},
+                         tPrevious[i], ray.t0[i], ray.t[i]);
+      });
+    }
+
+    void OOCBBV::beginFrame()
+    {
+      StructuredVolume::beginFrame();
+
+      // NOTE(jda) - the kernel may have dropped read ahead pages which were
+      //             never loaded, so prefetch hints only last a frame
+      if (blockPrefetched) {
+        for (size_t i = 0; i < numBlocks; ++i)
+          blockPrefetched[i].store(0, std::memory_order_relaxed);
+      }
+
+      if (logLevel() >= 3 && mappedMem) {
+        const auto s = cacheStats();
+        std::cout << "ospray: " << toString() << " block cache: " << s.hits
+                  << " hits, " << s.misses << " misses, " << s.evictions
+                  << " evictions, " << s.prefetches << " prefetches"
+                  << std::endl;
+      }
+    }
+
+    OOCBBV::CacheStats OOCBBV::cacheStats() const
+    {
+      std::lock_guard<std::mutex> lock(cacheMutex);
+      CacheStats result = stats;
+      result.prefetches = numPrefetches;
+      return result;
+    }
+
+    float OOCBBV::getVoxel(const vec3i &index) const
+    {
+      /* Compute the 1D address of the block in the volume
+       and the voxel in the block. */
+      Address address = getVoxelAddress(index);
+
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        return getVoxelValue<uint8>(address);
+        break;
+      case OSP_SHORT:
+        return getVoxelValue<int16>(address);
+        break;
+      case OSP_USHORT:
+        return getVoxelValue<uint16>(address);
+        break;
+      case OSP_FLOAT:
+        return getVoxelValue<float>(address);
+        break;
+      case OSP_DOUBLE:
+        return getVoxelValue<double>(address);
+        break;
+      default:
+        break;
+      }
+
+      return inf;
+    }
+
+    template<typename T>
+    inline void OOCBBV::getVoxelNeighborhood_T(const vec3i &index,
+                                               float corners[8]) const
+    {
+      const int mask  = BRICK_VOXEL_BITMASK;
+      const int width = BRICK_VOXEL_WIDTH;
+
+      const bool inBrick = (index.x & mask) < mask &&
+                           (index.y & mask) < mask &&
+                           (index.z & mask) < mask;
+
+      if (inBrick) {
+        const Address address = getVoxelAddress(index);
+        const T *voxels = (const T*)blockVoxels(address.block) +
+                          address.voxel;
+
+        for (int k = 0; k < 8; ++k) {
+          const int offset = (k & 1) +
+                             ((k >> 1) & 1) * width +
+                             (k >> 2) * width * width;
+          corners[k] = float(voxels[offset]);
+        }
+      } else {
+        // NOTE(jda) - each value is read before the next block is requested,
+        //             blockVoxels() only keeps the last one alive
+        for (int k = 0; k < 8; ++k) {
+          const vec3i corner = index + vec3i{k & 1, (k >> 1) & 1, k >> 2};
+          corners[k] = getVoxelValue<T>(getVoxelAddress(corner));
+        }
+      }
+    }
+
+    void OOCBBV::getVoxelNeighborhood(const vec3i &index,
+                                      float corners[8]) const
+    {
+      switch (voxel_t) {
+      case OSP_UCHAR:
+        getVoxelNeighborhood_T<uint8>(index, corners);
+        break;
+      case OSP_SHORT:
+        getVoxelNeighborhood_T<int16>(index, corners);
+        break;
+      case OSP_USHORT:
+        getVoxelNeighborhood_T<uint16>(index, corners);
+        break;
+      case OSP_FLOAT:
+        getVoxelNeighborhood_T<float>(index, corners);
+        break;
+      case OSP_DOUBLE:
+        getVoxelNeighborhood_T<double>(index, corners);
+        break;
+      default:
+        StructuredVolume::getVoxelNeighborhood(index, corners);
+        break;
+      }
+    }
+
+    uint32 OOCBBV::blockIndex(const vec3i &index) const
+    {
+      return getVoxelAddress(index).block;
+    }
+
+    void OOCBBV::buildAccelerator()
+    {
+      accelerator.resize(dimensions);
+
+      // NOTE(jda) - one block at a time: a single parallel_for over all cells
+      //             would touch every block at once and thrash the cache
+      for (int z = 0; z < blockCount.z; ++z) {
+        for (int y = 0; y < blockCount.y; ++y) {
+          for (int x = 0; x < blockCount.x; ++x) {
+            const vec3i lower = vec3i{x, y, z} * BLOCK_VOXEL_WIDTH;
+            const vec3i upper = min(lower + BLOCK_VOXEL_WIDTH - 1,
+                                    dimensions - 1);
+            updateAccelerator(lower, upper);
+          }
+        }
+      }
+    }
+
+    OOCBBV::Address OOCBBV::getVoxelAddress(const vec3i &index) const
+    {
+      Address address;
+
+      // Compute the 3D index of the block containing the brick containing the
+      // voxel.
+      const vec3i blockIndex {index.x >> BLOCK_VOXEL_WIDTH_BITCOUNT,
+                              index.y >> BLOCK_VOXEL_WIDTH_BITCOUNT,
+                              index.z >> BLOCK_VOXEL_WIDTH_BITCOUNT};
+
+      // Compute the 1D address of the block in the volume.
+      address.block =
+          blockIndex.x + blockCount.x * (blockIndex.y + blockCount.y * blockIndex.z);
+
+      // Compute the 3D offset of the brick within the block containing the voxel.
+      const vec3i brickIndex {index.x >> BRICK_VOXEL_WIDTH_BITCOUNT,
+                              index.y >> BRICK_VOXEL_WIDTH_BITCOUNT,
+                              index.z >> BRICK_VOXEL_WIDTH_BITCOUNT};
+      const vec3i brickOffset {brickIndex.x & BLOCK_BRICK_BITMASK,
+                               brickIndex.y & BLOCK_BRICK_BITMASK,
+                               brickIndex.z & BLOCK_BRICK_BITMASK};
+
+      // Compute the 1D address of the brick in the block.
+      const uint32 brickAddress
+        = brickOffset.x
+        + (brickOffset.y << BLOCK_BRICK_WIDTH_BITCOUNT)
+        + (brickOffset.z << 2 * BLOCK_BRICK_WIDTH_BITCOUNT);
+
+      // Compute the 3D offset of the voxel in the brick.
+      const vec3i voxelOffset {index.x & BRICK_VOXEL_BITMASK,
+                               index.y & BRICK_VOXEL_BITMASK,
+                               index.z & BRICK_VOXEL_BITMASK};
+
+      // Compute the 1D address of the voxel in the block.
+      address.voxel
+        = brickAddress  << (3 * BRICK_VOXEL_WIDTH_BITCOUNT)
+        | voxelOffset.z << (2 * BRICK_VOXEL_WIDTH_BITCOUNT)
+        | voxelOffset.y << BRICK_VOXEL_WIDTH_BITCOUNT
+        | voxelOffset.x;
+
+      return address;
+    }
+
+    OOCBBV::BlockPtr OOCBBV::acquireBlock(uint32 block) const
+    {
+      std::unique_lock<std::mutex> lock(cacheMutex);
+
+      auto entry = cachedBlocks.find(block);
+
+      if (entry != cachedBlocks.end()) {
+        lruBlocks.splice(lruBlocks.begin(), lruBlocks,
+                         entry->second.lruPosition);
+        stats.hits++;
+        return entry->second.voxels;
+      }
+
+      stats.misses++;
+
+      // NOTE(jda) - don't hold up other threads while paging the block in
+      lock.unlock();
+      BlockPtr voxels = loadBlock(block);
+      lock.lock();
+
+      // Another thread may have loaded the same block in the meantime.
+      entry = cachedBlocks.find(block);
+
+      if (entry != cachedBlocks.end()) {
+        lruBlocks.splice(lruBlocks.begin(), lruBlocks,
+                         entry->second.lruPosition);
+        return entry->second.voxels;
+      }
+
+      lruBlocks.push_front(block);
+      cachedBlocks[block] = CacheEntry{voxels, lruBlocks.begin()};
+      blockCached[block] = 1;
+
+      // The block just inserted is at the front, so it is never evicted here.
+      evictBlocks(maxCachedBlocks);
+
+      return voxels;
+    }
+
+    OOCBBV::BlockPtr OOCBBV::loadBlock(uint32 block) const
+    {
+      byte_t *voxels = new byte_t[blockBytes];
+      byte_t *source = mappedMem + uint64(block) * blockBytes;
+
+      std::memcpy(voxels, source, blockBytes);
+
+      // NOTE(jda) - the copy is all we keep resident, the file pages stay in
+      //             the page cache for the kernel to reclaim (dirty pages are
+      //             still written back)
+      madvise(source, blockBytes, MADV_DONTNEED);
+
+      return BlockPtr(voxels, std::default_delete<byte_t[]>());
+    }
+
+    void OOCBBV::evictBlocks(size_t maxBlocks) const
+    {
+      while (cachedBlocks.size() > maxBlocks) {
+        const uint32 block = lruBlocks.back();
+        lruBlocks.pop_back();
+        cachedBlocks.erase(block);
+        blockCached[block]     = 0;
+        blockPrefetched[block] = 0;
+        stats.evictions++;
+      }
+    }
+
+    void OOCBBV::invalidateBlocks(const vec3i &lower, const vec3i &upper)
+    {
+      const vec3i firstBlock = lower / BLOCK_VOXEL_WIDTH;
+      const vec3i lastBlock  = upper / BLOCK_VOXEL_WIDTH;
+
+      std::lock_guard<std::mutex> lock(cacheMutex);
+
+      for (int z = firstBlock.z; z <= lastBlock.z; ++z) {
+        for (int y = firstBlock.y; y <= lastBlock.y; ++y) {
+          for (int x = firstBlock.x; x <= lastBlock.x; ++x) {
+            const uint32 block = x + blockCount.x * (y + blockCount.y * z);
+            auto entry = cachedBlocks.find(block);
+
+            if (entry != cachedBlocks.end()) {
+              lruBlocks.erase(entry->second.lruPosition);
+              cachedBlocks.erase(entry);
+            }
+
+            blockCached[block]     = 0;
+            blockPrefetched[block] = 0;
+          }
+        }
+      }
+
+      // Threads still holding an old copy will ask the cache again.
+      generation = nextGeneration++;
+    }
+
+    uint32 OOCBBV::blockAt(const vec3f &worldCoordinates) const
+    {
+      const vec3f localCoordinates = clamp(transformWorldToLocal(worldCoordinates),
+                                           vec3f{0.0f},
+                                           vec3f{dimensions - 1});
+
+      return getVoxelAddress(vec3i{localCoordinates.x,
+                                   localCoordinates.y,
+                                   localCoordinates.z}).block;
+    }
+
+    void OOCBBV::prefetchBlock(uint32 block) const
+    {
+      if (blockCached[block] || blockPrefetched[block].exchange(1) != 0)
+        return;
+
+      madvise(mappedMem + uint64(block) * blockBytes, blockBytes,
+              MADV_WILLNEED);
+      numPrefetches++;
+    }
+
+    void OOCBBV::prefetchAlongRay(const vec3f &org, const vec3f &dir,
+                                  float tPrevious, float t, float tEnd) const
+    {
+      if (prefetchDistance <= 0.f || t >= tEnd)
+        return;
+
+      const float tAhead         = std::min(t + prefetchDistance, tEnd);
+      const float tPreviousAhead = std::min(tPrevious + prefetchDistance, tEnd);
+
+      // NOTE(jda) - only when the look ahead point enters a new block, to
+      //             keep the common case free of any cache traffic
+      const uint32 block = blockAt(org + tAhead * dir);
+
+      if (block != blockAt(org + tPreviousAhead * dir))
+        prefetchBlock(block);
+    }
+
+    void OOCBBV::constructVolumeMemory()
+    {
+      freeVolumeMemory();
+
+      // Get the voxel type.
+      voxelType = getParamString("voxelType", "unspecified");
+      voxel_t   = getVoxelType();
+      voxelSize = sizeOf(voxel_t);
+
+      // Get the volume dimensions.
+      this->dimensions = getParam3i("dimensions", vec3i(0));
+      exitOnCondition(reduce_min(this->dimensions) <= 0,
+                      "invalid volume dimensions (must be set before "
+                      "calling ospSetRegion())");
+
+      // Volume size in blocks per dimension with padding to the nearest block
+      blockCount = (dimensions + BLOCK_VOXEL_WIDTH - 1) / BLOCK_VOXEL_WIDTH;
+
+      // Volume size in blocks with padding.
+      numBlocks  = size_t(blockCount.x) * blockCount.y * blockCount.z;
+      blockBytes = BLOCK_VOXEL_COUNT * voxelSize;
+      mappedSize = blockBytes * numBlocks;
+
+      // Open (or create) the backing file.
+      std::string blockFile = getParamString("blockFile", "");
+
+      if (blockFile.empty()) {
+        // NOTE(jda) - not $TMPDIR or /tmp, which are often RAM backed (tmpfs)
+        //             and would page the volume right back into memory
+        blockFile = std::string(DEFAULT_BLOCK_DIRECTORY) +
+                    "/ospray_ooc_bbv_XXXXXX";
+
+        fileDescriptor = mkstemp(&blockFile[0]);
+        if (fileDescriptor < 0)
+          throw std::runtime_error(systemError("can't create " + blockFile));
+
+        // NOTE(jda) - the file goes away with the last reference to it
+        unlink(blockFile.c_str());
+      } else {
+        fileDescriptor = open(blockFile.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fileDescriptor < 0)
+          throw std::runtime_error(systemError("can't open " + blockFile));
+      }
+
+      struct stat fileStatus;
+      if (fstat(fileDescriptor, &fileStatus) != 0)
+        throw std::runtime_error(systemError("can't stat " + blockFile));
+
+      // An existing file of the right size already holds the bricked volume,
+      // a new (empty) one is sparsely sized to hold all blocks. Anything else
+      // is someone else's data, or a volume of other dimensions/voxel type.
+      if (fileStatus.st_size == 0) {
+        if (ftruncate(fileDescriptor, mappedSize) != 0)
+          throw std::runtime_error(systemError("can't resize " + blockFile));
+      } else if (size_t(fileStatus.st_size) != mappedSize) {
+        const size_t fileSize = fileStatus.st_size;
+        close(fileDescriptor);
+        fileDescriptor = -1;
+        throw std::runtime_error("cpp_ooc_bbv: " + blockFile + " holds " +
+                                 std::to_string(fileSize) + " bytes, the "
+                                 "volume needs " + std::to_string(mappedSize));
+      }
+
+      void *mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fileDescriptor, 0);
+      if (mapping == MAP_FAILED)
+        throw std::runtime_error(systemError("can't map the block file"));
+
+      mappedMem = (byte_t*)mapping;
+
+      blockCached.reset(new std::atomic<uint8>[numBlocks]);
+      blockPrefetched.reset(new std::atomic<uint8>[numBlocks]);
+      for (size_t i = 0; i < numBlocks; ++i) {
+        blockCached[i]     = 0;
+        blockPrefetched[i] = 0;
+      }
+
+      stats = CacheStats{};
+      numPrefetches = 0;
+      generation = nextGeneration++;
+    }
+
+    void OOCBBV::freeVolumeMemory()
+    {
+      {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        lruBlocks.clear();
+        cachedBlocks.clear();
+      }
+
+      if (mappedMem) munmap(mappedMem, mappedSize);
+      if (fileDescriptor >= 0) close(fileDescriptor);
+
+      mappedMem      = nullptr;
+      fileDescriptor = -1;
+      blockCached.reset();
+      blockPrefetched.reset();
+    }
+
+    // A block bricked volume paged in from a memory mapped file.
+    OSP_REGISTER_VOLUME(OutOfCoreBlockBrickedVolume, cpp_ooc_bbv);
+
+  } // ::ospray::cpp_renderer
+} // ::ospray
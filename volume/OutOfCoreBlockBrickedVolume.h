@@ -0,0 +1,285 @@
+// ======================================================================== //
+// Copyright 2009-2017 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "StructuredVolume.h"
+// std
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ospray {
+  namespace cpp_renderer {
+
+    /*! \brief a block bricked volume whose blocks live in a memory mapped
+     *         file instead of RAM
+
+        Voxels are stored in the same 64^3 block / 4^3 brick order as
+        BlockBrickedVolume, in a file (parameter "blockFile", by default an
+        unlinked file in /var/tmp, which unlike $TMPDIR or /tmp is rarely RAM
+        backed). An existing file of the right size is used as is, so a
+        volume bricked once can be reopened without setRegion() calls; a new
+        or empty one is sized to fit, any other size is an error.
+
+        "gradientVolume" is rejected, it would keep 3 bytes per voxel in
+        RAM.
+
+        Samples are taken from copies of whole blocks held in an LRU cache of
+        "cacheSize" megabytes (1024 by default). Each thread also keeps a
+        reference to the last block it sampled, which makes the cache lookup
+        rare for coherent rays. While marching, the block "prefetchDistance"
+        blocks (1 by default) ahead of each ray is handed to the kernel for
+        read ahead, so misses find the data in the page cache. */
+    class OutOfCoreBlockBrickedVolume : public StructuredVolume
+    {
+    public:
+
+      struct CacheStats
+      {
+        //! block lookups served by the shared cache (the per-thread last
+        //! block is not counted)
+        uint64 hits {0};
+        uint64 misses {0};
+        uint64 evictions {0};
+        //! blocks handed to the kernel for read ahead
+        uint64 prefetches {0};
+      };
+
+      OutOfCoreBlockBrickedVolume();
+      ~OutOfCoreBlockBrickedVolume();
+
+      std::string toString() const override;
+
+      void commit() override;
+
+      int setRegion(const void *source,
+                    const vec3i &index,
+                    const vec3i &count) override;
+
+      // cpp_renderer::Volume interface //
+
+      float computeSample(const vec3f &worldCoordinates) const override;
+
+      bool intersect(Ray &ray) const override;
+
+      void advance(Ray &ray) const override;
+      void advanceAdaptive(Ray &ray) const override;
+
+      void advanceN(simd::vmaski active, RayN &ray) const override;
+
+      void beginFrame() override;
+
+      //! totals since the volume memory was constructed
+      CacheStats cacheStats() const;
+
+    private:
+
+      // Helper types //
+
+      struct Address
+      {
+        //! The 1D address of the block in the volume containing the voxel.
+        uint32 block;
+
+        //! The 1D offset of the voxel in the enclosing block.
+        uint32 voxel;
+      };
+
+      //! a cached copy of one block, alive as long as someone samples it
+      using BlockPtr = std::shared_ptr<const byte_t>;
+
+      struct CacheEntry
+      {
+        BlockPtr voxels;
+        std::list<uint32>::iterator lruPosition;
+      };
+
+      struct LastBlock
+      {
+        const OutOfCoreBlockBrickedVolume *volume {nullptr};
+        uint64   generation {0};
+        uint32   block {0};
+        BlockPtr voxels;
+      };
+
+      // StructuredVolume interface //
+
+      float getVoxel(const vec3i &index) const override;
+
+      uint32 blockIndex(const vec3i &index) const override;
+
+      void getVoxelNeighborhood(const vec3i &index,
+                                float corners[8]) const override;
+
+      void buildAccelerator() override;
+
+      // Helper functions //
+
+      template <typename T>
+      float getVoxelValue(const Address &address) const;
+
+      template <typename T>
+      void getVoxelNeighborhood_T(const vec3i &index, float corners[8]) const;
+
+      template <typename T>
+      void setVoxelValues(void *_source,
+                          const vec3i &targetCoord000,
+                          const vec3i &regionSize,
+                          size_t taskIndex);
+
+      Address getVoxelAddress(const vec3i &index) const;
+
+      //! voxels of 'block', valid until this thread asks for another block
+      const byte_t *blockVoxels(uint32 block) const;
+
+      //! look 'block' up in the LRU cache, loading it from the file on a miss
+      BlockPtr acquireBlock(uint32 block) const;
+
+      BlockPtr loadBlock(uint32 block) const;
+
+      //! drop the least recently used blocks until at most 'maxBlocks'
+      //! remain, with cacheMutex held
+      void evictBlocks(size_t maxBlocks) const;
+
+      //! drop cached copies of the blocks holding voxels [lower, upper]
+      void invalidateBlocks(const vec3i &lower, const vec3i &upper);
+
+      //! block holding the voxel nearest to 'worldCoordinates'
+      uint32 blockAt(const vec3f &worldCoordinates) const;
+
+      //! ask the kernel to read 'block' ahead, unless it is cached or was
+      //! already prefetched this frame
+      void prefetchBlock(uint32 block) const;
+
+      //! prefetch the block 'prefetchDistance' ahead of a ray which advanced
+      //! from 'tPrevious' to 't', when that block changed
+      void prefetchAlongRay(const vec3f &org, const vec3f &dir,
+                            float tPrevious, float t, float tEnd) const;
+
+      void constructVolumeMemory();
+      void freeVolumeMemory();
+
+      // Data //
+
+      //! Volume size in blocks per dimension with padding to the nearest block.
+      vec3i blockCount;
+
+      //! Number of blocks (with padding).
+      size_t numBlocks {0};
+
+      //! Size of one block in bytes.
+      size_t blockBytes {0};
+
+      //! Backing file and its mapping.
+      int     fileDescriptor {-1};
+      byte_t *mappedMem {nullptr};
+      size_t  mappedSize {0};
+
+      //! Voxel type.
+      OSPDataType voxel_t {OSP_UNKNOWN};
+
+      //! Voxel size in bytes.
+      size_t voxelSize;
+
+      //! Maximum number of blocks held by the cache.
+      size_t maxCachedBlocks {1};
+
+      //! Look ahead distance along rays in world units.
+      float prefetchDistance {0.f};
+
+      /*! Changes whenever cached blocks become stale, so per-thread block
+          references are revalidated (unique across volumes). */
+      uint64 generation {0};
+
+      //! LRU cache state, most recently used block first.
+      mutable std::mutex cacheMutex;
+      mutable std::list<uint32> lruBlocks;
+      mutable std::unordered_map<uint32, CacheEntry> cachedBlocks;
+      mutable CacheStats stats;
+      mutable std::atomic<uint64> numPrefetches {0};
+
+      //! per block: held by the LRU cache
+      std::unique_ptr<std::atomic<uint8>[]> blockCached;
+
+      //! per block: handed to the kernel for read ahead this frame
+      std::unique_ptr<std::atomic<uint8>[]> blockPrefetched;
+
+      static thread_local LastBlock lastBlock;
+    };
+
+    // Inlined definitions ////////////////////////////////////////////////////
+
+    inline const byte_t *
+    OutOfCoreBlockBrickedVolume::blockVoxels(uint32 block) const
+    {
+      LastBlock &last = lastBlock;
+
+      if (last.volume != this || last.generation != generation ||
+          last.block != block || !last.voxels) {
+        last.voxels     = acquireBlock(block);
+        last.volume     = this;
+        last.generation = generation;
+        last.block      = block;
+      }
+
+      return last.voxels.get();
+    }
+
+    template<typename T>
+    inline float
+    OutOfCoreBlockBrickedVolume::getVoxelValue(const Address &address) const
+    {
+      const T *blockPtr = (const T*)blockVoxels(address.block);
+      return float(blockPtr[address.voxel]);
+    }
+
+    template<typename T>
+    inline void
+    OutOfCoreBlockBrickedVolume::setVoxelValues(void *_source,
+                                                const vec3i &targetCoord000,
+                                                const vec3i &regionSize,
+                                                size_t taskIndex)
+    {
+      const uint32 region_y = taskIndex % regionSize.y;
+      const uint32 region_z = taskIndex / regionSize.y;
+      const uint64 runOfs = (uint64)regionSize.x *
+                            (region_y + (uint64)regionSize.y * region_z);
+      const T *run = (const T *)_source + runOfs;
+      vec3i coord = targetCoord000 + vec3i{0, region_y, region_z};
+      for(int x = 0; x < regionSize.x; ++x) {
+        coord.x = targetCoord000.x + x;
+        if (coord.x < 0 ||
+            coord.y < 0 ||
+            coord.z < 0 ||
+            coord.x >= dimensions.x ||
+            coord.y >= dimensions.y ||
+            coord.z >= dimensions.z
+            )
+          continue;
+
+        // NOTE(jda) - writes go straight to the mapping, invalidateBlocks()
+        //             drops the cached copies afterwards
+        Address address = getVoxelAddress(coord);
+        T *blockPtr = (T*)(mappedMem + uint64(address.block) * blockBytes);
+        blockPtr[address.voxel] = run[x];
+      }
+    }
+
+  } // ::ospray::cpp_renderer
+} // ::ospray
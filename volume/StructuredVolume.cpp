@@ -16,10 +16,199 @@
 
 //ospray
 #include "StructuredVolume.h"
+#include "ospcommon/tasking/parallel_for.h"
+// std
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
 
 namespace ospray {
   namespace cpp_renderer {
 
+    // Helper functions ///////////////////////////////////////////////////////
+
+    /*! 3D DDA over a grid of 'numCells' cells of size 'width' (in local
+        coordinates), calling fcn(cell, tEnter, tExit) for the cells along
+        the ray in [t0, t1] until it returns true */
+    template <typename FCN_T>
+    static inline bool traverseGrid(const vec3f &org, const vec3f &dir,
+                                    float t0, float t1, float width,
+                                    const vec3i &numCells, FCN_T &&fcn)
+    {
+      const vec3f P = org + t0 * dir;
+
+      vec3i cell = clamp(vec3i{int(std::floor(P.x / width)),
+                               int(std::floor(P.y / width)),
+                               int(std::floor(P.z / width))},
+                         vec3i(0), numCells - 1);
+
+      vec3i step;
+      vec3f tMax, tDelta;
+
+      for (int a = 0; a < 3; ++a) {
+        if (dir[a] > 0.f) {
+          step[a]   = 1;
+          tMax[a]   = t0 + ((cell[a] + 1) * width - P[a]) / dir[a];
+          tDelta[a] = width / dir[a];
+        } else if (dir[a] < 0.f) {
+          step[a]   = -1;
+          tMax[a]   = t0 + (cell[a] * width - P[a]) / dir[a];
+          tDelta[a] = -width / dir[a];
+        } else {
+          step[a]   = 0;
+          tMax[a]   = inf;
+          tDelta[a] = inf;
+        }
+      }
+
+      float t = t0;
+
+      while (t < t1) {
+        const int   a     = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2)
+                                            : (tMax.y < tMax.z ? 1 : 2);
+        const float tNext = ospcommon::min(tMax[a], t1);
+
+        if (fcn(cell, t, tNext))
+          return true;
+
+        cell[a] += step[a];
+
+        if (cell[a] < 0 || cell[a] >= numCells[a])
+          break;
+
+        tMax[a] += tDelta[a];
+        t = tNext;
+      }
+
+      return false;
+    }
+
+    /*! first root in [0, s1] of the cubic c[0] + c[1]s + c[2]s^2 + c[3]s^3,
+        or a negative value if there is none */
+    static inline float firstRoot(const float c[4], float s1)
+    {
+      auto f = [&](float s) {
+        return ((c[3] * s + c[2]) * s + c[1]) * s + c[0];
+      };
+
+      // Split [0, s1] at the extrema of the cubic, so it is monotonic (and
+      // has at most one root) in each interval.
+      float bounds[4];
+      int   numBounds = 0;
+
+      bounds[numBounds++] = 0.f;
+
+      const float a = 3.f * c[3];
+      const float b = 2.f * c[2];
+
+      float extrema[2];
+      int   numExtrema = 0;
+
+      if (a != 0.f) {
+        const float d = b * b - 4.f * a * c[1];
+        if (d >= 0.f) {
+          const float sq = std::sqrt(d);
+          extrema[numExtrema++] = (-b - sq) / (2.f * a);
+          extrema[numExtrema++] = (-b + sq) / (2.f * a);
+          if (extrema[0] > extrema[1])
+            std::swap(extrema[0], extrema[1]);
+        }
+      } else if (b != 0.f) {
+        extrema[numExtrema++] = -c[1] / b;
+      }
+
+      for (int i = 0; i < numExtrema; ++i) {
+        if (extrema[i] > 0.f && extrema[i] < s1)
+          bounds[numBounds++] = extrema[i];
+      }
+
+      bounds[numBounds++] = s1;
+
+      float sLo = 0.f;
+      float fLo = f(sLo);
+
+      if (fLo == 0.f)
+        return 0.f;
+
+      for (int i = 1; i < numBounds; ++i) {
+        float sHi = bounds[i];
+        float fHi = f(sHi);
+
+        if ((fLo < 0.f) != (fHi < 0.f) || fHi == 0.f) {
+          // Regula falsi, interleaved with bisection so a stalled end point
+          // can't slow it down; the interval is monotonic.
+          for (int iter = 0; iter < 12; ++iter) {
+            float s = sLo - fLo * (sHi - sLo) / (fHi - fLo);
+            if ((iter & 1) || !(s > sLo && s < sHi))
+              s = 0.5f * (sLo + sHi);
+            const float fs = f(s);
+            if ((fs < 0.f) == (fLo < 0.f)) {
+              sLo = s;
+              fLo = fs;
+            } else {
+              sHi = s;
+              fHi = fs;
+            }
+          }
+
+          return sLo - fLo * (sHi - sLo) / (fHi - fLo);
+        }
+
+        sLo = sHi;
+        fLo = fHi;
+      }
+
+      return -1.f;
+    }
+
+    // Gradient packing /////////////////////////////////////////////////////
+
+    PackedGradient packGradient(const vec3f &gradient, float maxMagnitude)
+    {
+      const float magnitude = length(gradient);
+
+      if (magnitude <= 0.f || maxMagnitude <= 0.f)
+        return PackedGradient{128, 128, 0};
+
+      // Project the direction onto the octahedron, folding the lower half
+      // over the upper one.
+      const vec3f n = gradient / (std::abs(gradient.x) +
+                                  std::abs(gradient.y) +
+                                  std::abs(gradient.z));
+      float px = n.x;
+      float py = n.y;
+
+      if (n.z < 0.f) {
+        px = (1.f - std::abs(n.y)) * (n.x >= 0.f ? 1.f : -1.f);
+        py = (1.f - std::abs(n.x)) * (n.y >= 0.f ? 1.f : -1.f);
+      }
+
+      auto quantize = [](float x) {
+        return uint8(ospcommon::clamp(x, 0.f, 1.f) * 255.f + 0.5f);
+      };
+
+      return PackedGradient{quantize(px * 0.5f + 0.5f),
+                            quantize(py * 0.5f + 0.5f),
+                            quantize(std::sqrt(magnitude / maxMagnitude))};
+    }
+
+    vec3f unpackGradient(const PackedGradient &packed, float maxMagnitude)
+    {
+      const float px = packed.u * (2.f / 255.f) - 1.f;
+      const float py = packed.v * (2.f / 255.f) - 1.f;
+
+      vec3f n {px, py, 1.f - std::abs(px) - std::abs(py)};
+
+      const float t = ospcommon::max(-n.z, 0.f);
+      n.x += n.x >= 0.f ? -t : t;
+      n.y += n.y >= 0.f ? -t : t;
+
+      const float m = packed.magnitude * (1.f / 255.f);
+      return normalize(n) * (m * m * maxMagnitude);
+    }
+
+    // StructuredVolume definitions ///////////////////////////////////////////
+
     std::string StructuredVolume::toString() const
     {
       return("ospray::cpp_renderer::StructuredVolume<" + voxelType + ">");
@@ -53,13 +242,78 @@ namespace ospray {
         buildAccelerator();
         finished = true;
       }
+
+      // NOTE(jda) - the gradient volume is opt-in, it costs 3 bytes/voxel
+      if (!getParam1i("gradientVolume", 0)) {
+        gradientVolume.clear();
+      } else if (gradientVolume.empty()) {
+        gradientVolume.resize(size_t(dimensions.x) * dimensions.y *
+                              dimensions.z);
+        updateGradientVolume(vec3i(0), dimensions - 1);
+      }
     }
 
     void StructuredVolume::computeSamples(float **results,
                                           const vec3f *worldCoordinates,
                                           const size_t &count)
     {
-      NOT_IMPLEMENTED
+      // NOTE(jda) - the caller owns (and free()s) the results, so they can't
+      //             live in a std::vector
+      *results = (float*)malloc(count * sizeof(float));
+
+      if (*results == nullptr && count > 0)
+        throw std::runtime_error("error allocating volume sample results");
+
+      float *samples = *results;
+
+      // Each task buckets its own run of coordinates by the block holding
+      // them, so its packets gather from a few blocks instead of all over the
+      // volume. Runs are large enough that ordering across them gains little.
+      const size_t pointsPerTask = 64 * 1024;
+      const size_t numTasks = (count + pointsPerTask - 1) / pointsPerTask;
+
+      tasking::parallel_for(numTasks, [&](size_t task) {
+        const size_t begin = task * pointsPerTask;
+        const size_t end   = std::min(begin + pointsPerTask, count);
+        const size_t n     = end - begin;
+
+        std::vector<std::pair<uint32, uint32>> order(n);
+
+        for (size_t i = 0; i < n; ++i) {
+          const vec3f &wc   = worldCoordinates[begin + i];
+          const vec3f local = clamp(transformWorldToLocal(wc),
+                                    vec3f{0.f},
+                                    localCoordinatesUpperBound);
+          const vec3i index {int(local.x), int(local.y), int(local.z)};
+          order[i] = std::make_pair(blockIndex(index), uint32(i));
+        }
+
+        std::sort(order.begin(), order.end());
+
+        // Sample one SIMD packet at a time.
+        for (size_t first = 0; first < n; first += simd::width) {
+          const int packetSize = std::min<size_t>(simd::width, n - first);
+
+          simd::vint  lane;
+          simd::vec3f P;
+
+          for (int i = 0; i < simd::width; ++i) {
+            const size_t j = begin + order[first + std::min(i, packetSize-1)]
+                                         .second;
+            const vec3f &wc = worldCoordinates[j];
+            lane[i] = i;
+            P.x[i]  = wc.x;
+            P.y[i]  = wc.y;
+            P.z[i]  = wc.z;
+          }
+
+          const simd::vmaski active = lane < simd::vint(packetSize);
+          const simd::vfloat values = computeSampleN(active, P);
+
+          for (int i = 0; i < packetSize; ++i)
+            samples[begin + order[first + i].second] = values[i];
+        }
+      });
     }
 
     float StructuredVolume::computeSample(const vec3f &worldCoordinates) const
@@ -103,32 +357,55 @@ namespace ospray {
       return volumeSample;
     }
 
-    vec3f StructuredVolume::computeGradient(const vec3f &worldCoordinates) const
+    float
+    StructuredVolume::computeSampleAndGradient(const vec3f &worldCoordinates,
+                                               vec3f &gradient) const
     {
-      // Gradient step in each dimension (world coordinates).
-      const vec3f &gradientStep = gridSpacing;
-
-      // The gradient will be computed using central differences.
-      vec3f gradient;
-
-      // Sample at gradient location.
-      float sample = computeSample(worldCoordinates);
-
-      const auto step_x = vec3f{gradientStep.x, 0.0f, 0.0f};
-      const auto step_y = vec3f{0.0f, gradientStep.y, 0.0f};
-      const auto step_z = vec3f{0.0f, 0.0f, gradientStep.z};
-
-      // Gradient magnitude in the X direction.
-      gradient.x = computeSample(worldCoordinates + step_x) - sample;
-
-      // Gradient magnitude in the Y direction.
-      gradient.y = computeSample(worldCoordinates + step_y) - sample;
+      const vec3f clampedLocalCoordinates =
+          clamp(transformWorldToLocal(worldCoordinates),
+                vec3f{0.0f},
+                localCoordinatesUpperBound);
+
+      // "vi" means "voxelIndex", "flc" means "fractionalLocalCoordinates"
+      const vec3i vi  {int(clampedLocalCoordinates.x),
+                       int(clampedLocalCoordinates.y),
+                       int(clampedLocalCoordinates.z)};
+      const vec3f flc = clampedLocalCoordinates - vec3f{vi};
+
+      // One fetch of the cell's corners gives both the trilinear value and
+      // its derivatives.
+      float vv[8];
+      getVoxelNeighborhood(vi, vv);
+
+      const float vv_00 = vv[0] + flc.x * (vv[1] - vv[0]);
+      const float vv_01 = vv[2] + flc.x * (vv[3] - vv[2]);
+      const float vv_10 = vv[4] + flc.x * (vv[5] - vv[4]);
+      const float vv_11 = vv[6] + flc.x * (vv[7] - vv[6]);
+      const float vv_0  = vv_00 + flc.y * (vv_01 - vv_00);
+      const float vv_1  = vv_10 + flc.y * (vv_11 - vv_10);
+
+      if (!gradientVolume.empty()) {
+        gradient = sampleGradientVolume(vi, flc);
+      } else {
+        const float dx_0 = (vv[1] - vv[0]) + flc.y * ((vv[3] - vv[2]) -
+                                                      (vv[1] - vv[0]));
+        const float dx_1 = (vv[5] - vv[4]) + flc.y * ((vv[7] - vv[6]) -
+                                                      (vv[5] - vv[4]));
+
+        gradient = vec3f{dx_0 + flc.z * (dx_1 - dx_0),
+                         (vv_01 - vv_00) + flc.z * ((vv_11 - vv_10) -
+                                                    (vv_01 - vv_00)),
+                         vv_1 - vv_0} / gridSpacing;
+      }
 
-      // Gradient magnitude in the Z direction.
-      gradient.z = computeSample(worldCoordinates + step_z) - sample;
+      return vv_0 + flc.z * (vv_1 - vv_0);
+    }
 
-      // This approximation may yield image artifacts.
-      return gradient / gradientStep;
+    vec3f StructuredVolume::computeGradient(const vec3f &worldCoordinates) const
+    {
+      vec3f gradient;
+      computeSampleAndGradient(worldCoordinates, gradient);
+      return gradient;
     }
 
     bool StructuredVolume::intersect(Ray &ray) const
@@ -149,24 +426,304 @@ namespace ospray {
       // The recommended step size for ray casting based volume renderers.
       const float step = samplingStep / samplingRate;
 
-#if 0
-      // Compute the next hit point using a spatial acceleration structure.
-      GridAccelerator_intersect(volume->accelerator, step, ray);
-#else
       ray.t0 += step;
-#endif
+
+      // Skip over cells the transfer function makes fully transparent.
+      if (accelerator.classified())
+        ray.t0 = skipEmptyCells(ray.org, ray.dir, ray.t0, ray.t, step);
     }
 
     void StructuredVolume::advanceAdaptive(Ray &ray) const
     {
-      NOT_IMPLEMENTED
+      // NOTE(jda) - the rate is bounded by the opacity of whole cells, so
+      //             without a classified grid there is nothing to adapt to
+      if (!accelerator.classified()) {
+        advance(ray);
+        return;
+      }
+
+      const vec3f P    = ray.org + ray.t0 * ray.dir;
+      const vec3i cell = accelerator.cellAt(transformWorldToLocal(P));
+      const float rate = adaptiveSamplingRate(cell);
+      const float step = samplingStep / rate;
+
+      float t = ray.t0 + step;
+
+      // A large step which lands in a cell needing a higher rate may have
+      // jumped over the start of a feature: backtrack to just before the
+      // boundary of the current cell and refine from there.
+      const vec3f nextP    = ray.org + t * ray.dir;
+      const vec3i nextCell = accelerator.cellAt(transformWorldToLocal(nextP));
+
+      if (nextCell != cell) {
+        const float nextRate = adaptiveSamplingRate(nextCell);
+
+        if (nextRate > rate) {
+          const float tExit = cellExitDistance(ray.org, ray.dir, cell);
+          t = ospcommon::max(ray.t0 + samplingStep / nextRate,
+                             tExit - adaptiveBacktrack);
+        }
+      }
+
+      ray.t0 = skipEmptyCells(ray.org, ray.dir, t, ray.t, step);
+    }
+
+    float
+    StructuredVolume::adaptiveSamplingRate(const vec3f &worldCoordinates) const
+    {
+      if (!accelerator.classified())
+        return samplingRate;
+
+      const vec3f local = transformWorldToLocal(worldCoordinates);
+      return adaptiveSamplingRate(accelerator.cellAt(local));
     }
 
     void
     StructuredVolume::intersectIsosurface(const std::vector<float> &isovalues,
                                           Ray &ray) const
     {
-      NOT_IMPLEMENTED
+      if (isovalues.empty() || !finished)
+        return;
+
+      const auto hits = intersectBox(ray, boundingBox);
+
+      const float t0 = ospcommon::max(ray.t0, hits.first);
+      const float t1 = ospcommon::min(ray.t, hits.second);
+
+      if (t0 >= t1)
+        return;
+
+      // Traverse in local coordinates, the ray parameter stays the same.
+      const vec3f org = transformWorldToLocal(ray.org);
+      const vec3f dir = vec3f(ray.dir) * rcp(gridSpacing);
+
+      const vec3i numVoxels = max(dimensions - 1, vec3i(1));
+
+      // NOTE(jda) - only an axis one voxel thick puts a cell's upper corners
+      //             outside the volume, the rest use the brick-aware fetch
+      const bool thin = reduce_min(dimensions) < 2;
+
+      float tHit   = inf;
+      int   isoHit = -1;
+
+      auto straddles = [&](const vec2f &range) {
+        for (const float iso : isovalues)
+          if (range.x <= iso && iso <= range.y)
+            return true;
+        return false;
+      };
+
+      // Find the surface on the trilinear interpolant of each voxel.
+      auto intersectVoxel = [&](const vec3i &v, float tEnter, float tExit) {
+        float corner[8];
+        vec2f range {FLT_MAX, -FLT_MAX};
+
+        if (thin) {
+          for (int k = 0; k < 8; ++k) {
+            const vec3i index = min(v + vec3i{k & 1, (k >> 1) & 1, k >> 2},
+                                    dimensions - 1);
+            corner[k] = getVoxel(index);
+          }
+        } else {
+          getVoxelNeighborhood(v, corner);
+        }
+
+        for (int k = 0; k < 8; ++k) {
+          range.x = ospcommon::min(range.x, corner[k]);
+          range.y = ospcommon::max(range.y, corner[k]);
+        }
+
+        if (!straddles(range))
+          return false;
+
+        // The interpolant along the ray is a cubic in s = t - tEnter: a
+        // sum over the corners of products of three linear factors.
+        const vec3f a = org + tEnter * dir - vec3f{v};
+
+        float c[4] = {0.f, 0.f, 0.f, 0.f};
+
+        for (int k = 0; k < 8; ++k) {
+          const float x0 = (k & 1)        ? a.x : 1.f - a.x;
+          const float x1 = (k & 1)        ? dir.x : -dir.x;
+          const float y0 = ((k >> 1) & 1) ? a.y : 1.f - a.y;
+          const float y1 = ((k >> 1) & 1) ? dir.y : -dir.y;
+          const float z0 = (k >> 2)       ? a.z : 1.f - a.z;
+          const float z1 = (k >> 2)       ? dir.z : -dir.z;
+
+          c[0] += corner[k] * (x0 * y0 * z0);
+          c[1] += corner[k] * (x1 * y0 * z0 + x0 * y1 * z0 + x0 * y0 * z1);
+          c[2] += corner[k] * (x1 * y1 * z0 + x1 * y0 * z1 + x0 * y1 * z1);
+          c[3] += corner[k] * (x1 * y1 * z1);
+        }
+
+        for (size_t i = 0; i < isovalues.size(); ++i) {
+          if (isovalues[i] < range.x || isovalues[i] > range.y)
+            continue;
+
+          const float ci[4] = {c[0] - isovalues[i], c[1], c[2], c[3]};
+          const float s = firstRoot(ci, tExit - tEnter);
+
+          if (s >= 0.f && tEnter + s < tHit) {
+            tHit   = tEnter + s;
+            isoHit = int(i);
+          }
+        }
+
+        return isoHit >= 0;
+      };
+
+      // Only visit the voxels of macro cells whose range holds an isovalue.
+      const float cellWidth = GridAccelerator::CELL_WIDTH;
+
+      traverseGrid(org, dir, t0, t1, cellWidth, accelerator.cellCount(),
+                   [&](const vec3i &cell, float tEnter, float tExit) {
+        const vec2f &range = accelerator.range(accelerator.cellIndex(cell));
+
+        if (!straddles(range))
+          return false;
+
+        return traverseGrid(org, dir, tEnter, tExit, 1.f, numVoxels,
+                            intersectVoxel);
+      });
+
+      if (isoHit < 0)
+        return;
+
+      vec3f gradient;
+      computeSampleAndGradient(ray.org + tHit * ray.dir, gradient);
+
+      ray.t      = tHit;
+      ray.Ng     = gradient;
+      ray.primID = isoHit;
+      ray.geomID = 0;
+    }
+
+    simd::vfloat
+    StructuredVolume::computeSampleN(simd::vmaski active,
+                                     const simd::vec3f &worldCoordinates) const
+    {
+      // NOTE(jda) - generic fallback, layouts which can compute voxel
+      //             addresses for a whole packet should override this
+      simd::vfloat result {0.f};
+
+      simd::foreach_active(active, [&](int i) {
+        result[i] = computeSample(vec3f{worldCoordinates.x[i],
+                                        worldCoordinates.y[i],
+                                        worldCoordinates.z[i]});
+      });
+
+      return result;
+    }
+
+    simd::vmaski StructuredVolume::intersectN(simd::vmaski active,
+                                              RayN &ray) const
+    {
+      auto hits = intersectBox(ray, boundingBox);
+
+      auto hit = active & (hits.first < hits.second) & (hits.first < ray.t);
+
+      ray.t0 = simd::select(hit, hits.first, ray.t0);
+      ray.t  = simd::select(hit, hits.second, ray.t);
+
+      return hit;
+    }
+
+    void StructuredVolume::advanceN(simd::vmaski active, RayN &ray) const
+    {
+      // The recommended step size for ray casting based volume renderers.
+      const float step = samplingStep / samplingRate;
+
+      ray.t0 = simd::select(active, ray.t0 + step, ray.t0);
+
+      // NOTE(jda) - lanes diverge once they skip, so the cell traversal is
+      //             done per lane
+      if (accelerator.classified()) {
+        simd::foreach_active(active, [&](int i) {
+          ray.t0[i] = skipEmptyCells(vec3f{ray.org.x[i], ray.org.y[i],
+                                           ray.org.z[i]},
+                                     vec3f{ray.dir.x[i], ray.dir.y[i],
+                                           ray.dir.z[i]},
+                                     ray.t0[i], ray.t[i], step);
+        });
+      }
+    }
+
+    void StructuredVolume::beginFrame()
+    {
+      if (finished && transferFunction)
+        accelerator.classify(*transferFunction);
+
+      // NOTE(jda) - the table is built here, never lazily from the render
+      //             tasks, which would all wait on its (parallel) build
+      if (preIntegrationEnabled && transferFunction)
+        transferFunction->preparePreIntegration();
+    }
+
+    float StructuredVolume::skipEmptyCells(const vec3f &org,
+                                           const vec3f &dir,
+                                           float t0,
+                                           float t1,
+                                           float step) const
+    {
+      while (t0 < t1) {
+        const vec3f local = transformWorldToLocal(org + t0 * dir);
+        const vec3i cell  = accelerator.cellAt(local);
+
+        if (!accelerator.isEmpty(cell))
+          break;
+
+        const float tExit = cellExitDistance(org, dir, cell);
+
+        // Stay on the sample positions the ray would have visited anyway,
+        // so skipping doesn't change the image.
+        t0 += ospcommon::max(1.f, std::ceil((tExit - t0) / step)) * step;
+      }
+
+      return t0;
+    }
+
+    float StructuredVolume::cellExitDistance(const vec3f &org,
+                                             const vec3f &dir,
+                                             const vec3i &cell) const
+    {
+      // NOTE(jda) - avoid 0 * inf below for axis aligned rays
+      auto safeRcp = [](float d) {
+        return 1.f / (std::abs(d) < 1e-12f ? std::copysign(1e-12f, d) : d);
+      };
+
+      const vec3f rcpDir {safeRcp(dir.x), safeRcp(dir.y), safeRcp(dir.z)};
+      const float cellWidth = GridAccelerator::CELL_WIDTH;
+
+      const vec3f lower  = transformLocalToWorld(vec3f{cell} * cellWidth);
+      const vec3f upper  = transformLocalToWorld(vec3f{cell + 1} * cellWidth);
+      const vec3f tLower = (lower - org) * rcpDir;
+      const vec3f tUpper = (upper - org) * rcpDir;
+
+      return reduce_min(max(tLower, tUpper));
+    }
+
+    float StructuredVolume::adaptiveSamplingRate(const vec3i &cell) const
+    {
+      // NOTE(jda) - 'samplingRate' is the lowest rate, used where the
+      //             transfer function is (nearly) transparent
+      const float rate = adaptiveScalar * accelerator.maxOpacity(cell);
+      return ospcommon::max(samplingRate,
+                            ospcommon::min(rate, adaptiveMaxSamplingRate));
+    }
+
+    void StructuredVolume::getVoxelNeighborhood(const vec3i &index,
+                                                float corners[8]) const
+    {
+      for (int k = 0; k < 8; ++k)
+        corners[k] = getVoxel(index + vec3i{k & 1, (k >> 1) & 1, k >> 2});
+    }
+
+    uint32 StructuredVolume::blockIndex(const vec3i &index) const
+    {
+      const int   width = GridAccelerator::CELL_WIDTH;
+      const vec3i cells = (dimensions + width - 1) / width;
+      const vec3i cell  = index / width;
+      return (cell.z * cells.y + cell.y) * cells.x + cell.x;
     }
 
     vec3f
@@ -181,6 +738,24 @@ namespace ospray {
       return rcp(gridSpacing) * (worldCoords - gridOrigin);
     }
 
+    simd::vec3f
+    StructuredVolume::transformWorldToLocal(const simd::vec3f &worldCoords) const
+    {
+      const vec3f rcpSpacing = rcp(gridSpacing);
+      return {(worldCoords.x - gridOrigin.x) * rcpSpacing.x,
+              (worldCoords.y - gridOrigin.y) * rcpSpacing.y,
+              (worldCoords.z - gridOrigin.z) * rcpSpacing.z};
+    }
+
+    simd::vec3f
+    StructuredVolume::clampToVolume(const simd::vec3f &localCoords) const
+    {
+      const auto &upper = localCoordinatesUpperBound;
+      return {simd::min(simd::max(localCoords.x, 0.f), upper.x),
+              simd::min(simd::max(localCoords.y, 0.f), upper.y),
+              simd::min(simd::max(localCoords.z, 0.f), upper.z)};
+    }
+
     bool StructuredVolume::scaleRegion(const void *source, void *&out,
                                        vec3i &regionSize, vec3i &regionCoords)
     {
@@ -234,21 +809,135 @@ namespace ospray {
 
     void StructuredVolume::buildAccelerator()
     {
-#if 0
-      // Create instance of volume accelerator.
-      void *accel = ispc::StructuredVolume_createAccelerator(ispcEquivalent);
-
-      vec3i brickCount;
-      brickCount.x = ispc::GridAccelerator_getBrickCount_x(accel);
-      brickCount.y = ispc::GridAccelerator_getBrickCount_y(accel);
-      brickCount.z = ispc::GridAccelerator_getBrickCount_z(accel);
-
-      // Build volume accelerator.
-      const int NTASKS = brickCount.x * brickCount.y * brickCount.z;
-      parallel_for(NTASKS, [&](int taskIndex){
-        ispc::GridAccelerator_buildAccelerator(ispcEquivalent, taskIndex);
+      accelerator.resize(dimensions);
+      updateAccelerator(vec3i{0}, dimensions - 1);
+    }
+
+    void StructuredVolume::updateAccelerator(const vec3i &lower,
+                                             const vec3i &upper)
+    {
+      vec3i firstCell, lastCell;
+      accelerator.cellsOfVoxels(lower, upper, firstCell, lastCell);
+
+      const vec3i numCells = lastCell - firstCell + 1;
+      const int NTASKS = numCells.x * numCells.y * numCells.z;
+
+      // Compute the value range of each cell, including the voxels it shares
+      // with its upper neighbors.
+      tasking::parallel_for(NTASKS, [&](int taskIndex) {
+        const vec3i cell = firstCell +
+            vec3i{taskIndex % numCells.x,
+                  (taskIndex / numCells.x) % numCells.y,
+                  taskIndex / (numCells.x * numCells.y)};
+
+        const vec3i v0 = cell * GridAccelerator::CELL_WIDTH;
+        const vec3i v1 = min(v0 + GridAccelerator::CELL_WIDTH, dimensions - 1);
+
+        vec2f range {FLT_MAX, -FLT_MAX};
+
+        for (int z = v0.z; z <= v1.z; ++z) {
+          for (int y = v0.y; y <= v1.y; ++y) {
+            for (int x = v0.x; x <= v1.x; ++x) {
+              const float value = getVoxel(vec3i{x, y, z});
+              range.x = ospcommon::min(range.x, value);
+              range.y = ospcommon::max(range.y, value);
+            }
+          }
+        }
+
+        accelerator.range(accelerator.cellIndex(cell)) = range;
       });
-#endif
+
+      // The classification has to be redone with the new ranges.
+      accelerator.invalidate();
+    }
+
+    void StructuredVolume::updateGradientVolume(const vec3i &lower,
+                                                const vec3i &upper)
+    {
+      if (gradientVolume.empty())
+        return;
+
+      // The central differences of the neighbors change as well.
+      const vec3i first = max(lower - 1, vec3i(0));
+      const vec3i last  = min(upper + 1, dimensions - 1);
+      const vec3i count = last - first + 1;
+
+      const bool wholeVolume = first == vec3i(0) && last == dimensions - 1;
+
+      auto centralDifference = [&](const vec3i &v) {
+        vec3f gradient;
+        for (int a = 0; a < 3; ++a) {
+          vec3i lo = v;
+          vec3i hi = v;
+          lo[a] = ospcommon::max(v[a] - 1, 0);
+          hi[a] = ospcommon::min(v[a] + 1, dimensions[a] - 1);
+          gradient[a] = hi[a] == lo[a] ? 0.f :
+                        (getVoxel(hi) - getVoxel(lo)) /
+                        ((hi[a] - lo[a]) * gridSpacing[a]);
+        }
+        return gradient;
+      };
+
+      // The encoding is relative to the largest magnitude, find it first
+      // (the differences are recomputed below instead of stored in floats).
+      std::vector<float> sliceMax(count.z, 0.f);
+
+      tasking::parallel_for(count.z, [&](int z) {
+        for (int y = 0; y < count.y; ++y) {
+          for (int x = 0; x < count.x; ++x) {
+            const vec3f g = centralDifference(first + vec3i{x, y, z});
+            sliceMax[z] = ospcommon::max(sliceMax[z], length(g));
+          }
+        }
+      });
+
+      const float regionMax = *std::max_element(sliceMax.begin(),
+                                                sliceMax.end());
+
+      if (wholeVolume) {
+        maxGradientMagnitude = regionMax;
+      } else if (regionMax > maxGradientMagnitude) {
+        // NOTE(jda) - the other voxels are encoded relative to the old
+        //             maximum, so they need to be re-encoded as well
+        updateGradientVolume(vec3i(0), dimensions - 1);
+        return;
+      }
+
+      tasking::parallel_for(count.z, [&](int z) {
+        for (int y = 0; y < count.y; ++y) {
+          for (int x = 0; x < count.x; ++x) {
+            const vec3i v = first + vec3i{x, y, z};
+            const size_t i = (size_t(v.z) * dimensions.y + v.y) *
+                             dimensions.x + v.x;
+            gradientVolume[i] = packGradient(centralDifference(v),
+                                             maxGradientMagnitude);
+          }
+        }
+      });
+    }
+
+    vec3f StructuredVolume::sampleGradientVolume(const vec3i &index,
+                                                 const vec3f &frac) const
+    {
+      vec3f corners[8];
+
+      for (int k = 0; k < 8; ++k) {
+        const vec3i v = min(index + vec3i{k & 1, (k >> 1) & 1, k >> 2},
+                            dimensions - 1);
+        const size_t i = (size_t(v.z) * dimensions.y + v.y) *
+                         dimensions.x + v.x;
+        corners[k] = unpackGradient(gradientVolume[i], maxGradientMagnitude);
+      }
+
+      const vec3f g_00 = corners[0] + frac.x * (corners[1] - corners[0]);
+      const vec3f g_01 = corners[2] + frac.x * (corners[3] - corners[2]);
+      const vec3f g_10 = corners[4] + frac.x * (corners[5] - corners[4]);
+      const vec3f g_11 = corners[6] + frac.x * (corners[7] - corners[6]);
+      const vec3f g_0  = g_00 + frac.y * (g_01 - g_00);
+      const vec3f g_1  = g_10 + frac.y * (g_11 - g_10);
+
+      return g_0 + frac.z * (g_1 - g_0);
     }
 
     OSPDataType StructuredVolume::getVoxelType()
@@ -21,11 +21,24 @@
 #include "ospcommon/tasking/parallel_for.h"
 #endif
 
+#include "GridAccelerator.h"
 #include "Volume.h"
 
 namespace ospray {
   namespace cpp_renderer {
 
+    /*! a gradient in 3 bytes: its direction in octahedral encoding and
+        its magnitude relative to a per volume maximum (sqrt scaled, for
+        more precision on weak gradients) */
+    struct PackedGradient
+    {
+      uint8 u, v;
+      uint8 magnitude;
+    };
+
+    PackedGradient packGradient(const vec3f &gradient, float maxMagnitude);
+    vec3f unpackGradient(const PackedGradient &packed, float maxMagnitude);
+
     class StructuredVolume : public Volume
     {
     public:
@@ -51,25 +64,52 @@ namespace ospray {
 
       vec3f computeGradient(const vec3f &worldCoordinates) const override;
 
+      float computeSampleAndGradient(const vec3f &worldCoordinates,
+                                     vec3f &gradient) const override;
+
       bool intersect(Ray &ray) const override;
 
       void advance(Ray &ray) const override;
       void advanceAdaptive(Ray &ray) const override;
 
+      float adaptiveSamplingRate(const vec3f &worldCoordinates) const override;
+
       void intersectIsosurface(const std::vector<float> &isovalues,
                                Ray &ray) const override;
 
+      void beginFrame() override;
+
+      simd::vfloat computeSampleN(simd::vmaski active,
+                                  const simd::vec3f &worldCoordinates)
+                                  const override;
+
+      simd::vmaski intersectN(simd::vmaski active, RayN &ray) const override;
+
+      void advanceN(simd::vmaski active, RayN &ray) const override;
+
     protected:
 
       // Internal interface //
 
       virtual float getVoxel(const vec3i &index) const = 0;
 
+      //! the 8 voxels at the corners of the cell with lower corner 'index',
+      //! x varying fastest (8 getVoxel() calls by default)
+      virtual void getVoxelNeighborhood(const vec3i &index,
+                                        float corners[8]) const;
+
+      //! memory block holding voxel 'index', used to order batches of
+      //! samples for locality (the accelerator cell by default)
+      virtual uint32 blockIndex(const vec3i &index) const;
+
       // Interal methods //
 
       vec3f transformLocalToWorld(const vec3f &localCoords) const;
       vec3f transformWorldToLocal(const vec3f &worldCoords) const;
 
+      simd::vec3f transformWorldToLocal(const simd::vec3f &worldCoords) const;
+      simd::vec3f clampToVolume(const simd::vec3f &localCoords) const;
+
 #if 0
       template<typename T>
       void upsampleRegion(const T *source,
@@ -85,12 +125,41 @@ namespace ospray {
       //! building..
       virtual void buildAccelerator();
 
+      //! recompute the accelerator cells overlapping voxels [lower, upper],
+      //! called by setRegion() once the volume is committed
+      void updateAccelerator(const vec3i &lower, const vec3i &upper);
+
+      //! first sample distance (on the 'step' lattice from 't0') outside of
+      //! empty accelerator cells, or >= 't1' if there is none
+      float skipEmptyCells(const vec3f &org, const vec3f &dir,
+                           float t0, float t1, float step) const;
+
+      //! distance at which a ray leaves accelerator cell 'cell'
+      float cellExitDistance(const vec3f &org, const vec3f &dir,
+                             const vec3i &cell) const;
+
+      //! sampling rate inside 'cell', from the max opacity of its voxels
+      float adaptiveSamplingRate(const vec3i &cell) const;
+
+      //! recompute the gradients of the voxels [lower, upper] (and their
+      //! neighbors) if the gradient volume is enabled
+      void updateGradientVolume(const vec3i &lower, const vec3i &upper);
+
+      //! trilinear interpolation of the precomputed gradients
+      vec3f sampleGradientVolume(const vec3i &index, const vec3f &frac) const;
+
       //! Get the OSPDataType enum corresponding to the voxel type string.
       OSPDataType getVoxelType();
 
       // Data //
 
-      // TODO: ptr|ref to GridAccelerator
+      //! Macro cells for empty space skipping.
+      GridAccelerator accelerator;
+
+      /*! Optional precomputed (central difference) gradient per voxel, x
+          varying fastest, and the magnitude its encoding is relative to. */
+      std::vector<PackedGradient> gradientVolume;
+      float maxGradientMagnitude {0.f};
 
       //! Volume size in voxels per dimension.
       vec3i dimensions;
@@ -121,6 +190,53 @@ namespace ospray {
       vec3f localCoordinatesUpperBound;
     };
 
+// Inlined helper functions ///////////////////////////////////////////////////
+
+    /*! gather one voxel of type T per active lane, located 'offset' bytes
+        past the start of block 'block' (blocks are 'blockBytes' apart) */
+    template <typename T>
+    inline simd::vfloat gatherVoxels(simd::vmaski active,
+                                     const byte_t *mem,
+                                     size_t blockBytes,
+                                     const simd::vint &block,
+                                     const simd::vint &offset)
+    {
+      simd::vfloat result {0.f};
+
+      // NOTE(jda) - packets are coherent, so lanes usually share a block
+      simd::foreach_unique(active, block,
+                           [&](const simd::vmaski &sameBlock, int b) {
+        const byte_t *blockPtr = mem + uint64(b) * blockBytes;
+        simd::foreach_active(sameBlock, [&](int i) {
+          result[i] = float(*(const T*)(blockPtr + offset[i]));
+        });
+      });
+
+      return result;
+    }
+
+    template <>
+    inline simd::vfloat gatherVoxels<float>(simd::vmaski active,
+                                            const byte_t *mem,
+                                            size_t blockBytes,
+                                            const simd::vint &block,
+                                            const simd::vint &offset)
+    {
+      simd::vfloat result {0.f};
+
+      simd::foreach_unique(active, block,
+                           [&](const simd::vmaski &sameBlock, int b) {
+        auto *blockPtr = (const float*)(mem + uint64(b) * blockBytes);
+        result = simd::select(sameBlock,
+                              simd::vfloat::gather<1>(sameBlock,
+                                                      blockPtr,
+                                                      offset),
+                              result);
+      });
+
+      return result;
+    }
+
 // Inlined member functions ///////////////////////////////////////////////////
 
 #if 0
@@ -16,6 +16,7 @@
 
 // ospray
 #include "Volume.h"
+#include "common/Data.h"
 
 namespace ospray {
   namespace cpp_renderer {
@@ -41,6 +42,16 @@ namespace ospray {
 
       specular = getParam3f("specular", vec3f(0.3f));
 
+      // Set the isovalues rendered by isosurface renderers.
+      auto *isovaluesData = getParamData("isovalues", nullptr);
+
+      isovalues.clear();
+
+      if (isovaluesData) {
+        const float *values = (const float*)isovaluesData->data;
+        isovalues.assign(values, values + isovaluesData->numItems);
+      }
+
       // Set the volume clipping box (empty by default for no clipping).
       volumeClippingBox =
           box3f(getParam3f("volumeClippingBoxLower", vec3f(0.f)),
@@ -20,6 +20,7 @@
 #include "volume/Volume.h"
 // cpp_renderer
 #include "../common/Ray.h"
+#include "../common/RayN.h"
 #include "../transferFunction/TransferFunction.h"
 
 namespace ospray {
@@ -50,18 +51,52 @@ namespace ospray {
 
       virtual vec3f computeGradient(const vec3f &worldCoordinates) const = 0;
 
+      //! Compute the sample and its gradient at the given world coordinates.
+      virtual float computeSampleAndGradient(const vec3f &worldCoordinates,
+                                             vec3f &gradient) const
+      {
+        gradient = computeGradient(worldCoordinates);
+        return computeSample(worldCoordinates);
+      }
+
       virtual bool intersect(Ray &ray) const = 0;
 
       virtual void advance(Ray &ray) const = 0;
       virtual void advanceAdaptive(Ray &ray) const = 0;
 
+      //! Sampling rate advanceAdaptive() uses at the given world coordinates.
+      virtual float adaptiveSamplingRate(const vec3f &worldCoordinates) const
+      { return samplingRate; }
+
+      /*! \brief find the first isosurface of 'isovalues' along 'ray' in
+       *         [ray.t0, ray.t]
+
+          On a hit ray.t is the hit distance, ray.Ng the (world space)
+          gradient, ray.primID the index of the isovalue and ray.geomID is
+          set to 0. */
       virtual void intersectIsosurface(const std::vector<float> &isovalues,
                                        Ray &ray) const = 0;
 
+      /*! \brief called by renderers before rendering a frame (from a single
+       *         thread), updates state depending on the transfer function */
+      virtual void beginFrame() {}
+
+      // SIMD interface //
+
+      virtual simd::vfloat
+      computeSampleN(simd::vmaski active,
+                     const simd::vec3f &worldCoordinates) const = 0;
+
+      virtual simd::vmaski intersectN(simd::vmaski active, RayN &ray) const = 0;
+
+      virtual void advanceN(simd::vmaski active, RayN &ray) const = 0;
+
       // Data //
 
       Ref<TransferFunction> transferFunction;
 
+      std::vector<float> isovalues;
+
       bool gradientShadingEnabled  {false};
       bool preIntegrationEnabled   {false};
       bool singleShadingEnabled    {true};